@@ -2,23 +2,623 @@
 * Neural Net
 *
 * This is example shows the usage of nn by creating a neural network that learns the XOR function
-* with the backpropagation algorithm.
+* with the backpropagation algorithm. With --benchmark it measures the performance of the library
+* instead.
 *
 * @author Shivan Taher
 * @date 28.04.2009
 */
 
+#include <nn/BatchPipeline.h>
+#include <nn/Checkpointer.h>
+#include <nn/Dataset.h>
+#include <nn/FixedNet.h>
+#include <nn/InferenceNet.h>
+#include <nn/InferenceServer.h>
+#include <nn/Kernels.h>
 #include <nn/NeuralNet.h>
+#include <nn/ParallelTrainer.h>
+#include <nn/QuantizedNet.h>
+#include <nn/Simd.h>
+#include <nn/ThreadPool.h>
+#include <nn/Utils.h>
+
+#include <boost/program_options.hpp>
 
 #include <chrono>
+#include <fstream>
 #include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <thread>
 #include <time.h>
 #include <stdlib.h>
 
 using namespace std;
 
-int main() {
-    srand(time(0));
+namespace po = boost::program_options;
+
+/**
+* Compares the inference time and the accuracy of the sigmoid modes
+*/
+void benchmarkSigmoid() {
+    cout << "Sigmoid modes (64-512-512-16 network)\n";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, 64);
+    net.add(Layer::HIDDEN, 512);
+    net.add(Layer::HIDDEN, 512);
+    net.add(Layer::OUTPUT, 16);
+
+    vector<double> inputs(64);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+
+    net.setSigmoidMode(NeuralNet::EXACT);
+    vector<double> exactOutputs = net.calculateOutputs(inputs);
+
+    const int iterations = 2000;
+    const char* names[] = { "exact", "fast", "table" };
+    NeuralNet::SigmoidMode modes[] = { NeuralNet::EXACT, NeuralNet::FAST, NeuralNet::TABLE };
+
+    for (int m = 0; m < 3; m++) {
+        net.setSigmoidMode(modes[m]);
+
+        auto start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++)
+            net.calculateOutputs(inputs.data(), inputs.size());
+        auto end = chrono::high_resolution_clock::now();
+
+        const double* outputs = net.calculateOutputs(inputs.data(), inputs.size());
+        double maxError = 0;
+        for (size_t j = 0; j < exactOutputs.size(); j++)
+            maxError = max(maxError, fabs(outputs[j] - exactOutputs[j]));
+
+        cout << "  " << names[m] << ":\t";
+        cout << chrono::duration<double, micro>(end - start).count() / iterations << " us per inference, ";
+        cout << "max output error " << maxError << endl;
+    }
+
+    cout << "Sigmoid modes (activation of 1M net inputs)\n";
+
+    vector<double> netInputs(1 << 20), exact(netInputs.size()), approximated(netInputs.size());
+    for (double& netInput : netInputs)
+        netInput = randomDouble(-20, 20);
+
+    sigmoidExact(netInputs.size(), netInputs.data(), exact.data());
+
+    void (*functions[])(size_t, const double*, double*) = { sigmoidExact, sigmoidFast, sigmoidTable };
+
+    for (int m = 0; m < 3; m++) {
+        auto start = chrono::high_resolution_clock::now();
+        functions[m](netInputs.size(), netInputs.data(), approximated.data());
+        auto end = chrono::high_resolution_clock::now();
+
+        double maxError = 0;
+        for (size_t j = 0; j < exact.size(); j++)
+            maxError = max(maxError, fabs(approximated[j] - exact[j]));
+
+        cout << "  " << names[m] << ":\t";
+        cout << chrono::duration<double, nano>(end - start).count() / netInputs.size() << " ns per value, ";
+        cout << "max error " << maxError << endl;
+    }
+
+    cout << endl;
+}
+
+/**
+* Measures the inference time of a network with the scalar type T
+*/
+template<typename T>
+double measureInference(size_t width, int iterations) {
+    BasicNeuralNet<T> net("benchmark");
+    net.add(Layer::INPUT, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::OUTPUT, 16);
+
+    vector<T> inputs(width);
+    for (T& input : inputs)
+        input = (T) randomDouble(-1, 1);
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        net.calculateOutputs(inputs.data(), inputs.size());
+    auto end = chrono::high_resolution_clock::now();
+
+    return chrono::duration<double, micro>(end - start).count() / iterations;
+}
+
+/**
+* Compares the inference time of float and double networks
+*/
+void benchmarkPrecision() {
+    cout << "Scalar types (1024-1024-1024-16 network)\n";
+    cout << "  double:\t" << measureInference<double>(1024, 200) << " us per inference\n";
+    cout << "  float:\t" << measureInference<float>(1024, 200) << " us per inference\n";
+    cout << endl;
+}
+
+/**
+* Compares the memory footprint and the inference time of a trained and a frozen network
+*/
+void benchmarkInferenceNet() {
+    const size_t width = 1024;
+    const int iterations = 200;
+
+    cout << "Frozen inference network (1024-1024-1024-16 network)\n";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::OUTPUT, 16);
+
+    InferenceNet frozen(net);
+
+    vector<double> inputs(width), outputs(16);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        net.calculateOutputs(inputs.data(), inputs.size());
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "  NeuralNet:\t" << net.getArena().size() / 1024 << " KB, ";
+    cout << chrono::duration<double, micro>(end - start).count() / iterations << " us per inference\n";
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        frozen.calculateOutputs(inputs.data(), outputs.data());
+    end = chrono::high_resolution_clock::now();
+
+    const double* expected = net.calculateOutputs(inputs.data(), inputs.size());
+    double maxError = 0;
+    for (size_t j = 0; j < outputs.size(); j++)
+        maxError = max(maxError, fabs(outputs[j] - expected[j]));
+
+    cout << "  InferenceNet:\t" << frozen.getArena().size() / 1024 << " KB, ";
+    cout << chrono::duration<double, micro>(end - start).count() / iterations << " us per inference, ";
+    cout << "max output difference " << maxError << endl;
+    cout << endl;
+}
+
+/**
+* Compares the 8 bit quantized network with the double inference network: the drift of the outputs
+* on inputs which were not used for the calibration, the time of one sample and of a batch
+*/
+void benchmarkQuantizedNet() {
+    const size_t width = 1024, numOutputs = 16, numSamples = 256, batchSize = 64;
+    const int iterations = 200;
+
+    cout << "Quantized inference (1024-1024-1024-16 network, " << simdInt8Kernels().name << " kernels)\n";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::OUTPUT, numOutputs);
+
+    vector<double> calibration(numSamples * width), inputs(numSamples * width);
+    for (double& input : calibration)
+        input = randomDouble(-1, 1);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+
+    InferenceNet frozen(net);
+    QuantizedNet quantized;
+    quantized.quantize(net, calibration.data(), numSamples);
+
+    vector<double> expected(numSamples * numOutputs), outputs(numSamples * numOutputs);
+    frozen.calculateOutputsBatch(inputs.data(), numSamples, expected.data());
+    quantized.calculateOutputsBatch(inputs.data(), numSamples, outputs.data());
+
+    double maxDrift = 0, sumDrift = 0;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        maxDrift = max(maxDrift, fabs(outputs[i] - expected[i]));
+        sumDrift += fabs(outputs[i] - expected[i]);
+    }
+
+    cout << "  output drift:\tmax " << maxDrift << ", mean " << sumDrift / outputs.size() << endl;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        frozen.calculateOutputs(inputs.data(), outputs.data());
+    auto end = chrono::high_resolution_clock::now();
+
+    double frozenTime = chrono::duration<double, micro>(end - start).count() / iterations;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        quantized.calculateOutputs(inputs.data(), outputs.data());
+    end = chrono::high_resolution_clock::now();
+
+    double quantizedTime = chrono::duration<double, micro>(end - start).count() / iterations;
+
+    cout << "  1 sample:\tdouble " << frozenTime << " us, int8 " << quantizedTime << " us, ";
+    cout << "speedup " << frozenTime / quantizedTime << endl;
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations / 10; i++)
+        frozen.calculateOutputsBatch(inputs.data(), batchSize, outputs.data());
+    end = chrono::high_resolution_clock::now();
+
+    frozenTime = chrono::duration<double, micro>(end - start).count() / (iterations / 10);
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations / 10; i++)
+        quantized.calculateOutputsBatch(inputs.data(), batchSize, outputs.data());
+    end = chrono::high_resolution_clock::now();
+
+    quantizedTime = chrono::duration<double, micro>(end - start).count() / (iterations / 10);
+
+    cout << "  " << batchSize << " samples:\tdouble " << frozenTime << " us, int8 " << quantizedTime << " us, ";
+    cout << "speedup " << frozenTime / quantizedTime << endl;
+    cout << endl;
+}
+
+/**
+* Compares the inference time of the network types for the tiny XOR topology
+*/
+void benchmarkFixedNet() {
+    const int iterations = 1000000;
+
+    cout << "Fixed topology (2-2-1 network)\n";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, 2);
+    net.add(Layer::HIDDEN, 2);
+    net.add(Layer::OUTPUT, 1);
+
+    InferenceNet frozen(net);
+    FixedNet<2, 2, 1> fixed;
+    fixed.assign(net);
+
+    double inputs[2] = { 1, 0 }, output = 0, checksum = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        inputs[0] = i & 1;
+        checksum += net.calculateOutputs(inputs, 2)[0];
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "  NeuralNet:\t" << chrono::duration<double, nano>(end - start).count() / iterations << " ns per inference\n";
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        inputs[0] = i & 1;
+        frozen.calculateOutputs(inputs, &output);
+        checksum -= output;
+    }
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  InferenceNet:\t" << chrono::duration<double, nano>(end - start).count() / iterations << " ns per inference\n";
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        inputs[0] = i & 1;
+        fixed.calculateOutputs(inputs, &output);
+        checksum += output;
+    }
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  FixedNet:\t" << chrono::duration<double, nano>(end - start).count() / iterations << " ns per inference ";
+    cout << "(checksum " << checksum << ")\n";
+    cout << endl;
+}
+
+/**
+* Compares the latency of a single inference on wide layers with and without the thread pool
+*/
+void benchmarkThreadPool() {
+    const size_t width = 2048;
+    const int iterations = 100;
+
+    cout << "Intra-layer parallelism (2048-2048-2048-16 network, single sample)\n";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::HIDDEN, width);
+    net.add(Layer::OUTPUT, 16);
+
+    vector<double> inputs(width);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        net.calculateOutputs(inputs.data(), inputs.size());
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "  serial:\t" << chrono::duration<double, micro>(end - start).count() / iterations << " us per inference\n";
+
+    ThreadPool pool;
+    net.setThreadPool(&pool);
+
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++)
+        net.calculateOutputs(inputs.data(), inputs.size());
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  " << pool.getNumThreads() << " threads:\t";
+    cout << chrono::duration<double, micro>(end - start).count() / iterations << " us per inference\n";
+    cout << endl;
+}
+
+/**
+* Compares the training throughput of per-sample backpropagation and mini-batch training
+*/
+void benchmarkTraining() {
+    const size_t numSamples = 4096, numInputs = 64, numOutputs = 16, batchSize = 64;
+
+    cout << "Training (64-256-256-16 network, " << numSamples << " samples)\n";
+
+    vector<double> inputs(numSamples * numInputs), expectedOutputs(numSamples * numOutputs);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+    for (double& expectedOutput : expectedOutputs)
+        expectedOutput = randomDouble(0, 1);
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, numInputs);
+    net.add(Layer::HIDDEN, 256);
+    net.add(Layer::HIDDEN, 256);
+    net.add(Layer::OUTPUT, numOutputs);
+    net.setLearningRate(0.1);
+
+    vector<double> sampleInputs(numInputs), sampleOutputs(numOutputs);
+
+    auto start = chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numSamples; i++) {
+        sampleInputs.assign(&inputs[i * numInputs], &inputs[(i + 1) * numInputs]);
+        sampleOutputs.assign(&expectedOutputs[i * numOutputs], &expectedOutputs[(i + 1) * numOutputs]);
+        net.backpropagation(sampleInputs, sampleOutputs);
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "  per sample:\t";
+    cout << numSamples / chrono::duration<double>(end - start).count() << " samples/s\n";
+
+    start = chrono::high_resolution_clock::now();
+    net.train(inputs, expectedOutputs, batchSize, 1);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  batch of " << batchSize << ":\t";
+    cout << numSamples / chrono::duration<double>(end - start).count() << " samples/s\n";
+    cout << endl;
+}
+
+/**
+* Measures the scaling of the data-parallel and the asynchronous training from one thread to all cores
+*/
+void benchmarkParallelTraining() {
+    const size_t numSamples = 8192, numInputs = 64, numOutputs = 16, batchSize = 256;
+    size_t numCores = max(thread::hardware_concurrency(), 1u);
+
+    cout << "Data-parallel training (64-256-256-16 network, batches of " << batchSize << ")\n";
+
+    vector<double> inputs(numSamples * numInputs), expectedOutputs(numSamples * numOutputs);
+    for (double& input : inputs)
+        input = randomDouble(-1, 1);
+    for (double& expectedOutput : expectedOutputs)
+        expectedOutput = randomDouble(0, 1);
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, numInputs);
+    net.add(Layer::HIDDEN, 256);
+    net.add(Layer::HIDDEN, 256);
+    net.add(Layer::OUTPUT, numOutputs);
+    net.setLearningRate(0.1);
+
+    // 1, 2, 4, ... threads up to the number of cores
+    vector<size_t> threadCounts;
+    for (size_t numThreads = 1; numThreads < numCores; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(numCores);
+
+    double baseline = 0;
+
+    for (size_t numThreads : threadCounts) {
+        ParallelTrainer trainer(net, numThreads);
+
+        auto start = chrono::high_resolution_clock::now();
+        trainer.train(inputs, expectedOutputs, batchSize, 1);
+        auto end = chrono::high_resolution_clock::now();
+
+        double samplesPerSecond = numSamples / chrono::duration<double>(end - start).count();
+        if (numThreads == 1)
+            baseline = samplesPerSecond;
+
+        cout << "  " << numThreads << " threads:\t" << samplesPerSecond << " samples/s, ";
+        cout << "speedup " << samplesPerSecond / baseline << endl;
+    }
+
+    cout << "Asynchronous per-sample training (Hogwild)\n";
+
+    for (size_t numThreads : threadCounts) {
+        ParallelTrainer trainer(net, numThreads);
+
+        auto start = chrono::high_resolution_clock::now();
+        trainer.trainAsync(inputs, expectedOutputs, 1);
+        auto end = chrono::high_resolution_clock::now();
+
+        double samplesPerSecond = numSamples / chrono::duration<double>(end - start).count();
+        if (numThreads == 1)
+            baseline = samplesPerSecond;
+
+        cout << "  " << numThreads << " threads:\t" << samplesPerSecond << " samples/s, ";
+        cout << "speedup " << samplesPerSecond / baseline << endl;
+    }
+
+    cout << endl;
+}
+
+/**
+* Returns the size of a file in MB
+*/
+double fileSize(const char* filename) {
+    ifstream file(filename, ios::binary | ios::ate);
+    return file.tellg() / (1024.0 * 1024.0);
+}
+
+/**
+* Measures saving and loading a model with 10M parameters in the JSON and the binary format
+*/
+void benchmarkModelFiles() {
+    const char* jsonFile = "nn_benchmark.json";
+    const char* binaryFile = "nn_benchmark.bin";
+    const char* checkpointFile = "nn_benchmark.ckpt";
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, 2048);
+    net.add(Layer::HIDDEN, 2048);
+    net.add(Layer::HIDDEN, 2048);
+    net.add(Layer::HIDDEN, 1024);
+    net.add(Layer::OUTPUT, 16);
+
+    cout << "Model files (" << net.getNumParameters() << " parameters)\n";
+
+    auto start = chrono::high_resolution_clock::now();
+    bool saved = net.save(jsonFile);
+    auto end = chrono::high_resolution_clock::now();
+
+    if (!saved) {
+        cout << "  Could not write " << jsonFile << endl << endl;
+        return;
+    }
+
+    cout << "  JSON save:\t" << chrono::duration<double>(end - start).count() << " s, " << fileSize(jsonFile) << " MB\n";
+
+    NeuralNet loaded("loaded");
+
+    start = chrono::high_resolution_clock::now();
+    bool valid = loaded.load(jsonFile);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  JSON load:\t" << chrono::duration<double>(end - start).count() << " s" << (valid ? "" : " (failed)") << endl;
+
+    start = chrono::high_resolution_clock::now();
+    net.saveBinary(binaryFile);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  binary save:\t" << chrono::duration<double>(end - start).count() << " s, " << fileSize(binaryFile) << " MB\n";
+
+    start = chrono::high_resolution_clock::now();
+    valid = loaded.load(binaryFile);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  binary load:\t" << chrono::duration<double>(end - start).count() << " s" << (valid ? "" : " (failed)") << endl;
+
+    InferenceNet mapped;
+
+    start = chrono::high_resolution_clock::now();
+    valid = mapped.map(binaryFile);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  binary map:\t" << chrono::duration<double>(end - start).count() << " s" << (valid ? "" : " (failed)") << endl;
+
+    {
+        // The training thread only pays for the copy, the file is written in the background
+        Checkpointer checkpointer(net, checkpointFile);
+
+        start = chrono::high_resolution_clock::now();
+        checkpointer.snapshot();
+        end = chrono::high_resolution_clock::now();
+        checkpointer.wait();
+        auto written = chrono::high_resolution_clock::now();
+
+        cout << "  checkpoint:\t" << chrono::duration<double>(end - start).count() << " s snapshot, "
+             << chrono::duration<double>(written - start).count() << " s until written"
+             << (checkpointer.getNumWritten() == 1 ? "" : " (failed)") << endl;
+    }
+
+    cout << endl;
+
+    remove(jsonFile);
+    remove(binaryFile);
+    remove(checkpointFile);
+}
+
+/**
+* Measures reading a dataset from CSV, packing it and mapping the packed file
+*/
+void benchmarkDatasets() {
+    const char* csvFile = "nn_benchmark.csv";
+    const char* binaryFile = "nn_benchmark.data";
+    const size_t numSamples = 100000, numInputs = 64, numOutputs = 16;
+
+    FILE* file = fopen(csvFile, "w");
+    if (file == 0) {
+        cout << "Could not write " << csvFile << endl << endl;
+        return;
+    }
+
+    for (size_t i = 0; i < numSamples; ++i) {
+        for (size_t j = 0; j < numInputs + numOutputs; ++j)
+            fprintf(file, j == 0 ? "%.17g" : ",%.17g", randomDouble(-1, 1));
+        fputc('\n', file);
+    }
+
+    fclose(file);
+
+    cout << "Datasets (" << numSamples << " samples, " << numInputs << " inputs, " << numOutputs << " outputs)\n";
+
+    Dataset dataset;
+
+    auto start = chrono::high_resolution_clock::now();
+    bool valid = dataset.loadCsv(csvFile, numInputs, numOutputs);
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "  CSV load:\t" << chrono::duration<double>(end - start).count() << " s, " << fileSize(csvFile) << " MB"
+         << (valid ? "" : " (failed)") << endl;
+
+    dataset.saveBinary(binaryFile);
+
+    Dataset mapped;
+
+    start = chrono::high_resolution_clock::now();
+    valid = mapped.map(binaryFile);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  binary map:\t" << chrono::duration<double>(end - start).count() << " s, " << fileSize(binaryFile) << " MB"
+         << (valid ? "" : " (failed)") << endl;
+
+    NeuralNet net("benchmark");
+    net.add(Layer::INPUT, numInputs);
+    net.add(Layer::HIDDEN, 64);
+    net.add(Layer::OUTPUT, numOutputs);
+    net.setLearningRate(0.1);
+
+    start = chrono::high_resolution_clock::now();
+    net.train(mapped, 64, 1);
+    end = chrono::high_resolution_clock::now();
+
+    cout << "  epoch:\t" << chrono::duration<double>(end - start).count() << " s (mapped)" << endl;
+
+    {
+        // Shuffled batches gathered on a background thread while the previous batch is trained
+        BatchPipeline pipeline(mapped, 64);
+
+        start = chrono::high_resolution_clock::now();
+        net.train(pipeline, 1);
+        end = chrono::high_resolution_clock::now();
+
+        cout << "  epoch:\t" << chrono::duration<double>(end - start).count() << " s (mapped, shuffled by the pipeline)" << endl;
+    }
+
+    cout << endl;
+
+    remove(csvFile);
+    remove(binaryFile);
+}
+
+/**
+* Learns and tests the XOR function
+*/
+void xorExample() {
 
     NeuralNet net("xornet");
 
@@ -93,6 +693,213 @@ int main() {
 
     if (!net.save("export/nn.json"))
         cout << "Could not export file" << endl;
+}
+
+/**
+* Serves a saved model on a Unix socket or on stdin and stdout
+*/
+int serve(const po::variables_map& options) {
+    if (!options.count("model")) {
+        cerr << "--serve requires --model" << endl;
+        return 1;
+    }
+
+    const string& model = options["model"].as<string>();
+
+    // Binary models are mapped without copying the weights
+    InferenceNet net;
+    if (!net.map(model) && !net.load(model)) {
+        cerr << "Could not load " << model << endl;
+        return 1;
+    }
+
+    InferenceServer server(net, options["max-batch"].as<size_t>(), options["max-delay"].as<size_t>());
+
+    if (options.count("socket")) {
+        cerr << "Serving " << model << " on " << options["socket"].as<string>() << endl;
+        return server.listen(options["socket"].as<string>()) ? 0 : 1;
+    }
+
+    server.serve(0, 1);
+    return 0;
+}
+
+/**
+* Loads the dataset given by --data, packed datasets are mapped
+*/
+bool loadDataset(const po::variables_map& options, Dataset& dataset) {
+    if (!options.count("data")) {
+        cerr << "--train, --pack and --quantize require --data" << endl;
+        return false;
+    }
+
+    const string& data = options["data"].as<string>();
+
+    // CSV files need the number of input and output columns
+    if (Dataset::isBinary(data)) {
+        if (!dataset.map(data)) {
+            cerr << "Could not load " << data << endl;
+            return false;
+        }
+    } else {
+        if (!options.count("inputs") || !options.count("outputs")) {
+            cerr << "CSV datasets require --inputs and --outputs" << endl;
+            return false;
+        }
+
+        if (!dataset.loadCsv(data, options["inputs"].as<size_t>(), options["outputs"].as<size_t>())) {
+            cerr << "Could not load " << data << endl;
+            return false;
+        }
+    }
+
+    cerr << "Loaded " << dataset.getNumSamples() << " samples from " << data << endl;
+    return true;
+}
+
+/**
+* Reads a dataset from a CSV or a packed binary file, packs it and trains a network with it
+*/
+int train(const po::variables_map& options) {
+    Dataset dataset;
+    if (!loadDataset(options, dataset))
+        return 1;
+
+    if (options.count("pack") && !dataset.saveBinary(options["pack"].as<string>())) {
+        cerr << "Could not write " << options["pack"].as<string>() << endl;
+        return 1;
+    }
+
+    if (!options.count("train"))
+        return 0;
+
+    NeuralNet net("trained");
+    net.add(Layer::INPUT, dataset.getNumInputs());
+    net.add(Layer::HIDDEN, options["hidden"].as<size_t>());
+    net.add(Layer::OUTPUT, dataset.getNumOutputs());
+    net.setLearningRate(options["learning-rate"].as<double>());
+
+    size_t epochs = options["epochs"].as<size_t>();
+    BatchPipeline pipeline(dataset, options["batch-size"].as<size_t>());
+
+    for (size_t epoch = 1; epoch <= epochs; ++epoch) {
+        double standardError = net.train(pipeline, 1);
+        cerr << "Epoch " << epoch << ": error " << standardError << endl;
+    }
+
+    if (options.count("model") && !net.save(options["model"].as<string>()))
+        return 1;
+
+    return 0;
+}
+
+/**
+* Quantizes a saved model with the dataset as calibration data and reports the output drift on it
+*/
+int quantize(const po::variables_map& options) {
+    if (!options.count("model")) {
+        cerr << "--quantize requires --model" << endl;
+        return 1;
+    }
+
+    NeuralNet net("quantized");
+    if (!net.load(options["model"].as<string>()))
+        return 1;
+
+    Dataset dataset;
+    if (!loadDataset(options, dataset))
+        return 1;
+
+    QuantizedNet quantized;
+    if (!quantized.quantize(net, dataset)) {
+        cerr << "The dataset does not match the model" << endl;
+        return 1;
+    }
+
+    InferenceNet reference(net);
+    size_t numSamples = dataset.getNumSamples(), numOutputs = net.getNumOutputs();
+    vector<double> expected(numSamples * numOutputs), outputs(numSamples * numOutputs);
+
+    reference.calculateOutputsBatch(dataset.getInputs(), numSamples, expected.data());
+    quantized.calculateOutputsBatch(dataset.getInputs(), numSamples, outputs.data());
+
+    double maxDrift = 0, sumDrift = 0;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        maxDrift = max(maxDrift, fabs(outputs[i] - expected[i]));
+        sumDrift += fabs(outputs[i] - expected[i]);
+    }
+
+    cerr << "Output drift: max " << maxDrift << ", mean " << sumDrift / outputs.size() << endl;
+
+    if (!quantized.save(options["quantize"].as<string>())) {
+        cerr << "Could not write " << options["quantize"].as<string>() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    srand(time(0));
+
+    po::options_description description("Options");
+    description.add_options()
+        ("help", "show this help")
+        ("benchmark", "measure the performance of the library")
+        ("serve", "serve a saved model, one request per line of input values")
+        ("model", po::value<string>(), "the model to serve (JSON or binary)")
+        ("socket", po::value<string>(), "serve on this Unix socket instead of stdin and stdout")
+        ("max-batch", po::value<size_t>()->default_value(32), "maximum number of requests per batch")
+        ("max-delay", po::value<size_t>()->default_value(500), "maximum time in microseconds a request waits for its batch")
+        ("train", "train a network with one hidden layer on a dataset and save it to --model")
+        ("pack", po::value<string>(), "write the dataset in the packed binary format to this file")
+        ("quantize", po::value<string>(), "quantize --model to 8 bit weights, calibrated with --data, and save it to this file")
+        ("data", po::value<string>(), "the dataset (CSV or packed binary)")
+        ("inputs", po::value<size_t>(), "number of input columns of a CSV dataset")
+        ("outputs", po::value<size_t>(), "number of output columns of a CSV dataset")
+        ("hidden", po::value<size_t>()->default_value(16), "number of hidden neurons")
+        ("epochs", po::value<size_t>()->default_value(100), "number of training epochs")
+        ("batch-size", po::value<size_t>()->default_value(32), "number of samples per weight update")
+        ("learning-rate", po::value<double>()->default_value(0.5), "learning rate of the training");
+
+    po::variables_map options;
+    try {
+        po::store(po::parse_command_line(argc, argv, description), options);
+        po::notify(options);
+    } catch (const po::error& e) {
+        cerr << e.what() << endl << description;
+        return 1;
+    }
+
+    if (options.count("help")) {
+        cout << description;
+        return 0;
+    }
+
+    if (options.count("serve"))
+        return serve(options);
+
+    if (options.count("quantize"))
+        return quantize(options);
+
+    if (options.count("train") || options.count("pack"))
+        return train(options);
+
+    if (options.count("benchmark")) {
+        benchmarkSigmoid();
+        benchmarkPrecision();
+        benchmarkInferenceNet();
+        benchmarkQuantizedNet();
+        benchmarkFixedNet();
+        benchmarkThreadPool();
+        benchmarkTraining();
+        benchmarkParallelTraining();
+        benchmarkModelFiles();
+        benchmarkDatasets();
+        return 0;
+    }
+
+    xorExample();
 
     return 0;
 }
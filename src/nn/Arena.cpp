@@ -0,0 +1,45 @@
+/**
+* Arena
+*
+* The implementation of the aligned network arena.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Arena.h"
+
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+Arena::Arena()
+    : memory(0),
+      numBytes(0)
+{
+}
+
+Arena::~Arena() {
+    this->release();
+}
+
+void Arena::allocate(size_t numBytes) {
+    this->release();
+
+    if (numBytes == 0)
+        return;
+
+    void* block = 0;
+    if (posix_memalign(&block, ALIGNMENT, align(numBytes)) != 0)
+        throw bad_alloc();
+
+    memset(block, 0, align(numBytes));
+    this->memory = static_cast<char*>(block);
+    this->numBytes = numBytes;
+}
+
+void Arena::release() {
+    free(this->memory);
+    this->memory = 0;
+    this->numBytes = 0;
+}
@@ -0,0 +1,63 @@
+/**
+* Arena
+*
+* A single aligned memory block which holds all the parameters and the activations of a neural
+* network. The network computes the required size once its topology is known and places all its
+* buffers inside the arena, so the whole network lives in one allocation.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_ARENA_H
+#define _NEURAL_ARENA_H
+
+#include <cstddef>
+
+using namespace std;
+
+class Arena {
+public:
+    /**
+    * Alignment of the arena and of every block inside it (one cache line)
+    */
+    static const size_t ALIGNMENT = 64;
+
+    Arena();
+    ~Arena();
+
+    /**
+    * Allocates a zero-initialised block of the given size. A previously allocated block is released.
+    */
+    void allocate(size_t numBytes);
+
+    /**
+    * Releases the memory of the arena
+    */
+    void release();
+
+    /**
+    * Returns the beginning of the arena
+    */
+    char* data() { return this->memory; }
+    const char* data() const { return this->memory; }
+
+    /**
+    * Returns the size of the arena in bytes
+    */
+    size_t size() const { return this->numBytes; }
+
+    /**
+    * Rounds the given number of bytes up to the next multiple of the alignment
+    */
+    static size_t align(size_t numBytes) { return (numBytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    char* memory;
+    size_t numBytes;
+};
+
+#endif
@@ -0,0 +1,33 @@
+/**
+* Barrier
+*
+* The implementation of the reusable thread barrier.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Barrier.h"
+
+Barrier::Barrier(size_t numThreads)
+    : numThreads(numThreads),
+      numWaiting(0),
+      generation(0)
+{
+}
+
+void Barrier::wait() {
+    unique_lock<mutex> guard(this->lock);
+    size_t generation = this->generation;
+
+    // The last thread releases all others and starts the next generation
+    if (++this->numWaiting == this->numThreads) {
+        this->numWaiting = 0;
+        this->generation++;
+        this->condition.notify_all();
+        return;
+    }
+
+    while (generation == this->generation)
+        this->condition.wait(guard);
+}
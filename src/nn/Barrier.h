@@ -0,0 +1,40 @@
+/**
+* Barrier
+*
+* A reusable barrier for a fixed number of threads: wait() blocks until all threads have called
+* it, after which the barrier can be used again.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_BARRIER_H
+#define _NEURAL_BARRIER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+using namespace std;
+
+class Barrier {
+public:
+    Barrier(size_t numThreads);
+
+    /**
+    * Blocks until numThreads threads are waiting
+    */
+    void wait();
+
+private:
+    Barrier(const Barrier&);
+    Barrier& operator=(const Barrier&);
+
+    mutex lock;
+    condition_variable condition;
+    size_t numThreads;
+    size_t numWaiting;
+    size_t generation;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+* BatchPipeline
+*
+* The implementation of the prefetching batch pipeline.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "BatchPipeline.h"
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+template<typename T>
+BasicBatchPipeline<T>::BasicBatchPipeline(const BasicDataset<T>& dataset, size_t batchSize, bool shuffle)
+    : dataset(dataset),
+      batchSize(max(batchSize, (size_t) 1)),
+      shuffle(shuffle),
+      order(dataset.getNumSamples()),
+      random(rand()),
+      numProduced(0),
+      numConsumed(0),
+      numReleased(0),
+      stopped(false)
+{
+    for (size_t i = 0; i < this->order.size(); ++i)
+        this->order[i] = i;
+
+    for (size_t buffer = 0; buffer < 2; ++buffer) {
+        this->inputs[buffer].resize(this->batchSize * dataset.getNumInputs());
+        this->outputs[buffer].resize(this->batchSize * dataset.getNumOutputs());
+        this->sizes[buffer] = 0;
+    }
+
+    this->producer = thread(&BasicBatchPipeline<T>::run, this);
+}
+
+template<typename T>
+BasicBatchPipeline<T>::~BasicBatchPipeline() {
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopped = true;
+    }
+
+    this->changed.notify_all();
+    this->producer.join();
+}
+
+template<typename T>
+size_t BasicBatchPipeline<T>::next() {
+    unique_lock<mutex> guard(this->lock);
+
+    // Release the current batch, so its buffer can take the batch after the next one
+    this->numReleased = this->numConsumed;
+    this->changed.notify_all();
+
+    while (this->numProduced == this->numConsumed)
+        this->changed.wait(guard);
+
+    return this->sizes[this->numConsumed++ % 2];
+}
+
+template<typename T>
+const T* BasicBatchPipeline<T>::getInputs() const {
+    return this->inputs[(this->numConsumed + 1) % 2].data();
+}
+
+template<typename T>
+const T* BasicBatchPipeline<T>::getOutputs() const {
+    return this->outputs[(this->numConsumed + 1) % 2].data();
+}
+
+template<typename T>
+const BasicDataset<T>& BasicBatchPipeline<T>::getDataset() const {
+    return this->dataset;
+}
+
+template<typename T>
+size_t BasicBatchPipeline<T>::getBatchSize() const {
+    return this->batchSize;
+}
+
+template<typename T>
+void BasicBatchPipeline<T>::run() {
+    size_t numSamples = this->order.size();
+    size_t first = 0;
+
+    while (true) {
+        size_t batch;
+
+        {
+            unique_lock<mutex> guard(this->lock);
+
+            while (!this->stopped && this->numProduced >= this->numReleased + 2)
+                this->changed.wait(guard);
+
+            if (this->stopped)
+                return;
+
+            batch = this->numProduced;
+        }
+
+        if (first == 0 && this->shuffle)
+            std::shuffle(this->order.begin(), this->order.end(), this->random);
+
+        // An empty batch marks the end of the epoch
+        size_t n = min(this->batchSize, numSamples - first);
+        this->gather(batch % 2, first, n);
+        first = n > 0 ? first + n : 0;
+
+        {
+            lock_guard<mutex> guard(this->lock);
+            this->numProduced++;
+        }
+
+        this->changed.notify_all();
+    }
+}
+
+template<typename T>
+void BasicBatchPipeline<T>::gather(size_t buffer, size_t first, size_t n) {
+    size_t numInputs = this->dataset.getNumInputs();
+    size_t numOutputs = this->dataset.getNumOutputs();
+
+    for (size_t i = 0; i < n; ++i) {
+        size_t sample = this->order[first + i];
+        memcpy(&this->inputs[buffer][i * numInputs], this->dataset.getInputs(sample), numInputs * sizeof(T));
+        memcpy(&this->outputs[buffer][i * numOutputs], this->dataset.getOutputs(sample), numOutputs * sizeof(T));
+    }
+
+    this->sizes[buffer] = n;
+}
+
+template class BasicBatchPipeline<float>;
+template class BasicBatchPipeline<double>;
@@ -0,0 +1,96 @@
+/**
+* BatchPipeline
+*
+* Prefetches the mini-batches of a dataset on a background thread. While the training works on
+* the current batch, the thread gathers the samples of the next batch in a random order into a
+* second buffer, so the training does not wait for page faults of a mapped dataset or for the
+* scattered reads of the shuffled samples. Every epoch uses a new random order.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_BATCH_PIPELINE_H
+#define _NEURAL_BATCH_PIPELINE_H
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Dataset.h"
+
+using namespace std;
+
+template<typename T>
+class BasicBatchPipeline {
+public:
+    /**
+    * Starts prefetching batches of batchSize samples of the dataset (the last batch of an epoch
+    * may be smaller). Without shuffle the samples are taken in the order of the dataset. The
+    * dataset must exist as long as the pipeline.
+    */
+    BasicBatchPipeline(const BasicDataset<T>& dataset, size_t batchSize, bool shuffle = true);
+    ~BasicBatchPipeline();
+
+    /**
+    * Releases the current batch, waits for the next one and returns its size. Returns 0 at the
+    * end of an epoch, the following call returns the first batch of the next epoch.
+    */
+    size_t next();
+
+    /**
+    * Returns the inputs of the current batch (batch size x numInputs)
+    */
+    const T* getInputs() const;
+
+    /**
+    * Returns the expected outputs of the current batch (batch size x numOutputs)
+    */
+    const T* getOutputs() const;
+
+    const BasicDataset<T>& getDataset() const;
+    size_t getBatchSize() const;
+
+private:
+    BasicBatchPipeline(const BasicBatchPipeline&);
+    BasicBatchPipeline& operator=(const BasicBatchPipeline&);
+
+    /**
+    * The loop of the background thread: gather the next batch into the free buffer, repeat
+    */
+    void run();
+
+    /**
+    * Copies the samples [first, first + n) of the current order into the given buffer
+    */
+    void gather(size_t buffer, size_t first, size_t n);
+
+    const BasicDataset<T>& dataset;
+    size_t batchSize;
+    bool shuffle;
+
+    vector<size_t> order;
+    mt19937 random;
+
+    // Two buffers: the batch of the training and the one being prefetched
+    vector<T> inputs[2];
+    vector<T> outputs[2];
+    size_t sizes[2];
+
+    // Batch k is stored in buffer k % 2 and can be produced once batch k - 2 is released
+    size_t numProduced;
+    size_t numConsumed;
+    size_t numReleased;
+    bool stopped;
+
+    mutex lock;
+    condition_variable changed;
+    thread producer;
+};
+
+typedef BasicBatchPipeline<double> BatchPipeline;
+
+#endif
@@ -0,0 +1,169 @@
+/**
+* BinaryModel
+*
+* The implementation of the binary model format.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "BinaryModel.h"
+#include "Arena.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+static const char BINARY_MODEL_MAGIC[8] = "NNMODEL";
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+* One entry of the layer table
+*/
+struct BinaryLayerHeader {
+    uint64_t numNeurons;
+    uint64_t hasBias;
+};
+
+size_t binaryModelSectionSize(const ModelTopology& topology, size_t scalarSize) {
+    size_t numBytes = 0;
+
+    for (size_t i = 1; i < topology.layerSizes.size(); ++i) {
+        size_t numInputs = topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0);
+        numBytes += Arena::align(topology.layerSizes[i] * numInputs * scalarSize);
+    }
+
+    return numBytes;
+}
+
+bool isBinaryModel(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == 0)
+        return false;
+
+    char magic[sizeof(BINARY_MODEL_MAGIC)];
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, BINARY_MODEL_MAGIC, sizeof(magic)) == 0;
+
+    fclose(file);
+    return binary;
+}
+
+bool writeBinaryModel(const string& filename, const ModelTopology& topology, size_t scalarSize,
+                      const char* weights, const char* deltaWeights) {
+    size_t numLayers = topology.layerSizes.size();
+    size_t sectionSize = binaryModelSectionSize(topology, scalarSize);
+    size_t tableEnd = sizeof(BinaryModelHeader) + numLayers * sizeof(BinaryLayerHeader);
+
+    BinaryModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_MODEL_MAGIC, sizeof(header.magic));
+    header.version = BINARY_MODEL_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.scalarSize = scalarSize;
+    header.numLayers = numLayers;
+    header.useBias = topology.useBias;
+    header.hasDeltaWeights = deltaWeights != 0;
+    header.biasValue = topology.biasValue;
+    header.weightsOffset = Arena::align(tableEnd);
+    header.deltaWeightsOffset = deltaWeights != 0 ? header.weightsOffset + sectionSize : 0;
+    header.sectionSize = sectionSize;
+
+    vector<char> table(header.weightsOffset - sizeof(header), 0);
+    for (size_t i = 0; i < numLayers; ++i) {
+        BinaryLayerHeader layer = { topology.layerSizes[i], topology.layerBiases[i] };
+        memcpy(&table[i * sizeof(layer)], &layer, sizeof(layer));
+    }
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == 0)
+        return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(table.data(), 1, table.size(), file) == table.size() &&
+                   fwrite(weights, 1, sectionSize, file) == sectionSize &&
+                   (deltaWeights == 0 || fwrite(deltaWeights, 1, sectionSize, file) == sectionSize);
+
+    return fclose(file) == 0 && written;
+}
+
+bool readBinaryModel(const char* data, size_t size, BinaryModelHeader& header, ModelTopology& topology) {
+    if (size < sizeof(header))
+        return false;
+
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, BINARY_MODEL_MAGIC, sizeof(header.magic)) != 0 || header.version != BINARY_MODEL_VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || (header.scalarSize != sizeof(float) && header.scalarSize != sizeof(double)) ||
+        header.numLayers < 2 || sizeof(header) + header.numLayers * sizeof(BinaryLayerHeader) > size)
+        return false;
+
+    topology = ModelTopology();
+    topology.scalarType = header.scalarSize == sizeof(float) ? "float" : "double";
+    topology.useBias = header.useBias != 0;
+    topology.biasValue = header.biasValue;
+
+    for (size_t i = 0; i < header.numLayers; ++i) {
+        BinaryLayerHeader layer;
+        memcpy(&layer, data + sizeof(header) + i * sizeof(layer), sizeof(layer));
+
+        if (layer.numNeurons == 0)
+            return false;
+
+        topology.layerSizes.push_back(layer.numNeurons);
+        topology.layerBiases.push_back(i > 0 && layer.hasBias != 0);
+    }
+
+    // The weights of all layers must fit into the file, this is checked by dividing before the
+    // sizes are multiplied, so corrupt layer sizes can not overflow the section size
+    uint64_t maxValues = size / header.scalarSize;
+
+    for (size_t i = 1; i < topology.layerSizes.size(); ++i) {
+        if (topology.layerSizes[i - 1] > maxValues)
+            return false;
+
+        uint64_t numInputs = topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0);
+        if (topology.layerSizes[i] > maxValues / numInputs)
+            return false;
+
+        maxValues -= topology.layerSizes[i] * numInputs;
+    }
+
+    // The sections must be aligned and inside the file
+    uint64_t sectionSize = binaryModelSectionSize(topology, header.scalarSize);
+
+    if (header.sectionSize != sectionSize || header.weightsOffset % Arena::ALIGNMENT != 0 ||
+        header.weightsOffset > size || sectionSize > size - header.weightsOffset)
+        return false;
+
+    if (header.hasDeltaWeights &&
+        (header.deltaWeightsOffset % Arena::ALIGNMENT != 0 || header.deltaWeightsOffset > size ||
+         sectionSize > size - header.deltaWeightsOffset))
+        return false;
+
+    return true;
+}
+
+template<typename T>
+void readBinaryModelSection(const char* section, const ModelTopology& topology, size_t scalarSize,
+                            const vector<T*>& layerWeights) {
+    for (size_t i = 1; i < topology.layerSizes.size(); ++i) {
+        size_t numInputs = topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0);
+        size_t numWeights = topology.layerSizes[i] * numInputs;
+
+        if (scalarSize == sizeof(T)) {
+            memcpy(layerWeights[i], section, numWeights * sizeof(T));
+        } else if (scalarSize == sizeof(float)) {
+            const float* values = reinterpret_cast<const float*>(section);
+            copy(values, values + numWeights, layerWeights[i]);
+        } else {
+            const double* values = reinterpret_cast<const double*>(section);
+            for (size_t j = 0; j < numWeights; ++j)
+                layerWeights[i][j] = (T) values[j];
+        }
+
+        section += Arena::align(numWeights * scalarSize);
+    }
+}
+
+template void readBinaryModelSection<float>(const char*, const ModelTopology&, size_t, const vector<float*>&);
+template void readBinaryModelSection<double>(const char*, const ModelTopology&, size_t, const vector<double*>&);
@@ -0,0 +1,99 @@
+/**
+* BinaryModel
+*
+* The binary model format. A file starts with a 64 byte header, followed by a table with the size
+* and the bias flag of every layer. The weights follow at a 64 byte aligned offset with the same
+* layout as in the arena of a network: the row-major weight matrix of each layer, every matrix
+* padded to a multiple of 64 bytes. An optional section with the delta weights of the training has
+* the same layout. All values are stored in the byte order of the writer, which is recorded in the
+* header. Since the weights need no conversion, they can be used straight from a mapped file.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_BINARY_MODEL_H
+#define _NEURAL_BINARY_MODEL_H
+
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+#include "ModelReader.h"
+
+using namespace std;
+
+/**
+* The current version of the format
+*/
+static const uint32_t BINARY_MODEL_VERSION = 1;
+
+struct BinaryModelHeader {
+    /**
+    * "NNMODEL" with a terminating 0
+    */
+    char magic[8];
+
+    uint32_t version;
+
+    /**
+    * 0x01020304 written in the byte order of the writer
+    */
+    uint32_t byteOrder;
+
+    /**
+    * Size of a weight in bytes (4 for float, 8 for double)
+    */
+    uint32_t scalarSize;
+
+    uint32_t numLayers;
+    uint32_t useBias;
+    uint32_t hasDeltaWeights;
+    double biasValue;
+
+    /**
+    * Offset of the weights and of the delta weights (0 if not present) from the start of the file
+    */
+    uint64_t weightsOffset;
+    uint64_t deltaWeightsOffset;
+
+    /**
+    * Size of the weight section (and of the delta weight section) in bytes
+    */
+    uint64_t sectionSize;
+};
+
+/**
+* Returns the size of the weight section for the given topology and scalar size, which is also
+* the size of the weights in the arena of a network
+*/
+size_t binaryModelSectionSize(const ModelTopology& topology, size_t scalarSize);
+
+/**
+* Returns true if the file starts with the magic of the binary format
+*/
+bool isBinaryModel(const string& filename);
+
+/**
+* Writes a binary model. weights (and deltaWeights, which may be 0) point to sections in the
+* arena layout of the given topology.
+*/
+bool writeBinaryModel(const string& filename, const ModelTopology& topology, size_t scalarSize,
+                      const char* weights, const char* deltaWeights);
+
+/**
+* Checks the header and the layer table of a binary model in memory and returns its topology.
+* The sections in the header are checked against the size of the data.
+*/
+bool readBinaryModel(const char* data, size_t size, BinaryModelHeader& header, ModelTopology& topology);
+
+/**
+* Copies a weight section with values of scalarSize bytes into the weight matrices of the layers
+* (one pointer per layer, the one of the input layer is not used), converting between float and
+* double if necessary
+*/
+template<typename T>
+void readBinaryModelSection(const char* section, const ModelTopology& topology, size_t scalarSize,
+                            const vector<T*>& layerWeights);
+
+#endif
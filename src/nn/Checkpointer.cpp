@@ -0,0 +1,167 @@
+/**
+* Checkpointer
+*
+* The implementation of the background checkpointing.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Checkpointer.h"
+#include "BinaryModel.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+template<typename T>
+BasicCheckpointer<T>::BasicCheckpointer(const BasicNeuralNet<T>& net, const string& filename)
+    : net(net),
+      filename(filename),
+      topology(net.getTopology()),
+      sectionSize(binaryModelSectionSize(topology, sizeof(T))),
+      pending(-1),
+      writing(-1),
+      numWritten(0),
+      stopped(false)
+{
+    // The weights and the delta weights of a snapshot
+    for (vector<char>& buffer : this->buffers)
+        buffer.resize(2 * this->sectionSize);
+
+    this->writer = thread(&BasicCheckpointer<T>::run, this);
+}
+
+template<typename T>
+BasicCheckpointer<T>::~BasicCheckpointer() {
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopped = true;
+    }
+
+    this->changed.notify_all();
+    this->writer.join();
+}
+
+template<typename T>
+void BasicCheckpointer<T>::snapshot() {
+    this->takeSnapshot(false);
+}
+
+template<typename T>
+void BasicCheckpointer<T>::snapshotRelaxed() {
+    this->takeSnapshot(true);
+}
+
+template<typename T>
+void BasicCheckpointer<T>::takeSnapshot(bool relaxed) {
+    int target;
+
+    {
+        lock_guard<mutex> guard(this->lock);
+
+        // Use the buffer which is not being written, a pending snapshot in it is replaced
+        target = this->writing == 0 ? 1 : 0;
+        if (this->pending == target)
+            this->pending = -1;
+    }
+
+    // The writer never touches a buffer which is neither pending nor being written
+    const BasicLayer<T>& firstLayer = this->net.getLayer(1);
+    char* buffer = this->buffers[target].data();
+
+    if (relaxed) {
+        // Other threads store to the weights, the delta weights are not changed by them
+        T* weights = reinterpret_cast<T*>(buffer);
+        for (size_t i = 0; i < this->sectionSize / sizeof(T); ++i)
+            __atomic_load(&firstLayer.weights[i], &weights[i], __ATOMIC_RELAXED);
+    } else {
+        memcpy(buffer, firstLayer.weights, this->sectionSize);
+    }
+
+    memcpy(buffer + this->sectionSize, firstLayer.deltaWeights, this->sectionSize);
+
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->pending = target;
+    }
+
+    this->changed.notify_all();
+}
+
+template<typename T>
+void BasicCheckpointer<T>::wait() {
+    unique_lock<mutex> guard(this->lock);
+
+    while (this->pending >= 0 || this->writing >= 0)
+        this->changed.wait(guard);
+}
+
+template<typename T>
+size_t BasicCheckpointer<T>::getNumWritten() const {
+    lock_guard<mutex> guard(this->lock);
+    return this->numWritten;
+}
+
+template<typename T>
+void BasicCheckpointer<T>::run() {
+    unique_lock<mutex> guard(this->lock);
+
+    while (true) {
+        while (!this->stopped && this->pending < 0)
+            this->changed.wait(guard);
+
+        // The last snapshot is written before the checkpointer is destroyed
+        if (this->pending < 0)
+            return;
+
+        this->writing = this->pending;
+        this->pending = -1;
+
+        guard.unlock();
+        bool written = this->write(this->buffers[this->writing]);
+        guard.lock();
+
+        if (written)
+            this->numWritten++;
+        else
+            cerr << "Could not write checkpoint " << this->filename << endl;
+
+        this->writing = -1;
+        this->changed.notify_all();
+    }
+}
+
+template<typename T>
+bool BasicCheckpointer<T>::write(const vector<char>& buffer) {
+    string temporary = this->filename + ".tmp";
+
+    if (!writeBinaryModel(temporary, this->topology, sizeof(T), buffer.data(), buffer.data() + this->sectionSize))
+        return false;
+
+    // The data must be on the disk before the rename makes it the checkpoint
+    int fd = open(temporary.c_str(), O_RDONLY);
+    bool synced = fd >= 0 && fsync(fd) == 0;
+
+    if (fd >= 0)
+        close(fd);
+
+    if (!synced || rename(temporary.c_str(), this->filename.c_str()) != 0)
+        return false;
+
+    // The rename itself is only durable once the directory entry is on the disk
+    size_t slash = this->filename.rfind('/');
+    string directory = slash == string::npos ? "." : slash == 0 ? "/" : this->filename.substr(0, slash);
+
+    fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    synced = fd >= 0 && fsync(fd) == 0;
+
+    if (fd >= 0)
+        close(fd);
+
+    return synced;
+}
+
+template class BasicCheckpointer<float>;
+template class BasicCheckpointer<double>;
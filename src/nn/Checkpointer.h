@@ -0,0 +1,105 @@
+/**
+* Checkpointer
+*
+* Writes checkpoints of a network during the training without stalling it. snapshot() copies the
+* weights and the delta weights into one of two buffers and returns, a background thread writes the
+* buffer in the binary model format to a temporary file and renames it to the checkpoint file, so
+* the checkpoint file is always complete. While one buffer is written, the next snapshot goes to
+* the other one; a snapshot which has not been written yet is replaced by a newer one.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_CHECKPOINTER_H
+#define _NEURAL_CHECKPOINTER_H
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ModelReader.h"
+#include "NeuralNet.h"
+
+using namespace std;
+
+template<typename T>
+class BasicCheckpointer {
+public:
+    /**
+    * Creates a checkpointer which writes the given network to filename. The topology of the
+    * network must not change while the checkpointer exists.
+    */
+    BasicCheckpointer(const BasicNeuralNet<T>& net, const string& filename);
+
+    /**
+    * Waits until the last snapshot is written
+    */
+    ~BasicCheckpointer();
+
+    /**
+    * Copies the current weights and delta weights and schedules writing them. Must be called by the
+    * thread which trains the network, between two weight updates.
+    */
+    void snapshot();
+
+    /**
+    * Like snapshot, but the weights are copied with relaxed atomic loads, so other threads may
+    * update them with applyGradientsRelaxed at the same time (asynchronous training). Must be
+    * called by one thread only.
+    */
+    void snapshotRelaxed();
+
+    /**
+    * Waits until all snapshots are written
+    */
+    void wait();
+
+    /**
+    * Returns the number of checkpoints which have been written
+    */
+    size_t getNumWritten() const;
+
+private:
+    BasicCheckpointer(const BasicCheckpointer&);
+    BasicCheckpointer& operator=(const BasicCheckpointer&);
+
+    /**
+    * Copies the weights and the delta weights into a free buffer and marks it pending
+    */
+    void takeSnapshot(bool relaxed);
+
+    /**
+    * The loop of the writing thread
+    */
+    void run();
+
+    /**
+    * Writes a buffer to the temporary file, renames it to the checkpoint file and syncs the
+    * directory, so the checkpoint survives a crash of the machine
+    */
+    bool write(const vector<char>& buffer);
+
+    const BasicNeuralNet<T>& net;
+    string filename;
+    ModelTopology topology;
+    size_t sectionSize;
+
+    vector<char> buffers[2];
+
+    // Index of the buffer which waits for writing and of the one being written (-1 for none)
+    int pending;
+    int writing;
+    size_t numWritten;
+    bool stopped;
+
+    mutable mutex lock;
+    condition_variable changed;
+    thread writer;
+};
+
+typedef BasicCheckpointer<double> Checkpointer;
+
+#endif
@@ -0,0 +1,401 @@
+/**
+* Dataset
+*
+* The implementation of the dataset with the CSV reader and the binary format.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Dataset.h"
+#include "Arena.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t CHUNK_SIZE = 1 << 20;
+
+static const char BINARY_DATASET_MAGIC[8] = "NNDATA";
+static const uint32_t BINARY_DATASET_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct BinaryDatasetHeader {
+    /**
+    * "NNDATA" padded with 0
+    */
+    char magic[8];
+
+    uint32_t version;
+
+    /**
+    * 0x01020304 written in the byte order of the writer
+    */
+    uint32_t byteOrder;
+
+    /**
+    * Size of a value in bytes (4 for float, 8 for double)
+    */
+    uint32_t scalarSize;
+    uint32_t reserved;
+
+    uint64_t numSamples;
+    uint64_t numInputs;
+    uint64_t numOutputs;
+
+    /**
+    * Offsets of the input and the output matrix from the start of the file
+    */
+    uint64_t inputsOffset;
+    uint64_t outputsOffset;
+};
+
+static inline void parseValue(const char* text, char** end, double& value) {
+    value = strtod(text, end);
+}
+
+static inline void parseValue(const char* text, char** end, float& value) {
+    value = strtof(text, end);
+}
+
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+* Parses n comma separated values of the line [text, lineEnd), which is followed by a newline
+*/
+template<typename T>
+static bool parseLine(const char* text, const char* lineEnd, size_t n, T* values) {
+    for (size_t i = 0; i < n; ++i) {
+        while (isBlank(*text))
+            text++;
+
+        if (i > 0) {
+            if (*text != ',')
+                return false;
+
+            text++;
+            while (isBlank(*text))
+                text++;
+        }
+
+        // strtod would skip the newline and continue with the next line
+        if (text >= lineEnd || *text == ',')
+            return false;
+
+        char* valueEnd;
+        parseValue(text, &valueEnd, values[i]);
+
+        if (valueEnd == text || valueEnd > lineEnd)
+            return false;
+
+        text = valueEnd;
+    }
+
+    while (text < lineEnd && isBlank(*text))
+        text++;
+
+    return text == lineEnd;
+}
+
+/**
+* Returns true if the line only consists of blanks
+*/
+static bool isEmptyLine(const char* text, const char* lineEnd) {
+    while (text < lineEnd && isBlank(*text))
+        text++;
+
+    return text == lineEnd;
+}
+
+/**
+* Returns true if the line can not start with a number, i.e. it is a header
+*/
+static bool isHeaderLine(const char* text, const char* lineEnd) {
+    while (text < lineEnd && isBlank(*text))
+        text++;
+
+    return text < lineEnd && strchr("0123456789+-.", *text) == 0;
+}
+
+/**
+* Checks the header of a binary dataset against the size of the file
+*/
+static bool readHeader(const MappedFile& file, BinaryDatasetHeader& header) {
+    if (file.size() < sizeof(header))
+        return false;
+
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (memcmp(header.magic, BINARY_DATASET_MAGIC, sizeof(header.magic)) != 0 || header.version != BINARY_DATASET_VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || (header.scalarSize != sizeof(float) && header.scalarSize != sizeof(double)) ||
+        header.numInputs == 0 || header.numOutputs == 0)
+        return false;
+
+    // The matrices must be aligned and inside the file
+    uint64_t maxValues = file.size() / header.scalarSize;
+
+    if (header.numSamples > maxValues / header.numInputs || header.numSamples > maxValues / header.numOutputs)
+        return false;
+
+    uint64_t inputsSize = header.numSamples * header.numInputs * header.scalarSize;
+    uint64_t outputsSize = header.numSamples * header.numOutputs * header.scalarSize;
+
+    return header.inputsOffset % Arena::ALIGNMENT == 0 && header.outputsOffset % Arena::ALIGNMENT == 0 &&
+           header.inputsOffset >= sizeof(header) && header.inputsOffset <= file.size() &&
+           inputsSize <= file.size() - header.inputsOffset && header.outputsOffset >= header.inputsOffset + inputsSize &&
+           header.outputsOffset <= file.size() && outputsSize <= file.size() - header.outputsOffset;
+}
+
+/**
+* Converts n values of scalarSize bytes into the scalar type T
+*/
+template<typename T>
+static void copyValues(const char* data, size_t scalarSize, size_t n, T* values) {
+    if (scalarSize == sizeof(T)) {
+        memcpy(values, data, n * sizeof(T));
+    } else if (scalarSize == sizeof(float)) {
+        const float* source = reinterpret_cast<const float*>(data);
+        copy(source, source + n, values);
+    } else {
+        const double* source = reinterpret_cast<const double*>(data);
+        for (size_t i = 0; i < n; ++i)
+            values[i] = (T) source[i];
+    }
+}
+
+template<typename T>
+BasicDataset<T>::BasicDataset()
+    : numSamples(0),
+      numInputs(0),
+      numOutputs(0),
+      inputs(0),
+      outputs(0)
+{
+}
+
+template<typename T>
+bool BasicDataset<T>::loadCsv(const string& filename, size_t numInputs, size_t numOutputs) {
+    this->clear();
+
+    if (numInputs == 0 || numOutputs == 0)
+        return false;
+
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == 0)
+        return false;
+
+    size_t numValues = numInputs + numOutputs;
+    vector<T> values(numValues);
+
+    // Holds the incomplete last line of the previous chunk followed by the next chunk
+    vector<char> buffer(CHUNK_SIZE + 2);
+    size_t end = 0;
+    size_t lineNumber = 0;
+    bool finished = false;
+    bool valid = true;
+
+    while (valid && !finished) {
+        if (buffer.size() - end < CHUNK_SIZE + 2)
+            buffer.resize(end + CHUNK_SIZE + 2);
+
+        size_t numBytes = fread(&buffer[end], 1, CHUNK_SIZE, file);
+        end += numBytes;
+
+        if (numBytes == 0) {
+            finished = true;
+            valid = ferror(file) == 0;
+
+            // Terminate the last line
+            if (end > 0 && buffer[end - 1] != '\n')
+                buffer[end++] = '\n';
+        }
+
+        buffer[end] = 0;
+
+        size_t position = 0;
+        while (valid) {
+            const char* line = &buffer[position];
+            const char* lineEnd = static_cast<const char*>(memchr(line, '\n', end - position));
+            if (lineEnd == 0)
+                break;
+
+            position = lineEnd - &buffer[0] + 1;
+            lineNumber++;
+
+            if (isEmptyLine(line, lineEnd) || (lineNumber == 1 && isHeaderLine(line, lineEnd)))
+                continue;
+
+            if (!parseLine(line, lineEnd, numValues, values.data())) {
+                cerr << "Invalid sample in line " << lineNumber << " of " << filename << endl;
+                valid = false;
+                break;
+            }
+
+            this->inputBuffer.insert(this->inputBuffer.end(), values.begin(), values.begin() + numInputs);
+            this->outputBuffer.insert(this->outputBuffer.end(), values.begin() + numInputs, values.end());
+        }
+
+        memmove(&buffer[0], &buffer[position], end - position);
+        end -= position;
+    }
+
+    fclose(file);
+
+    if (!valid) {
+        this->clear();
+        return false;
+    }
+
+    this->numInputs = numInputs;
+    this->numOutputs = numOutputs;
+    this->numSamples = this->inputBuffer.size() / numInputs;
+    this->inputs = this->inputBuffer.data();
+    this->outputs = this->outputBuffer.data();
+    return true;
+}
+
+template<typename T>
+bool BasicDataset<T>::load(const string& filename) {
+    this->clear();
+
+    MappedFile file;
+    BinaryDatasetHeader header;
+
+    if (!file.open(filename) || !readHeader(file, header))
+        return false;
+
+    this->numSamples = header.numSamples;
+    this->numInputs = header.numInputs;
+    this->numOutputs = header.numOutputs;
+
+    this->inputBuffer.resize(this->numSamples * this->numInputs);
+    this->outputBuffer.resize(this->numSamples * this->numOutputs);
+
+    copyValues(file.data() + header.inputsOffset, header.scalarSize, this->inputBuffer.size(), this->inputBuffer.data());
+    copyValues(file.data() + header.outputsOffset, header.scalarSize, this->outputBuffer.size(), this->outputBuffer.data());
+
+    this->inputs = this->inputBuffer.data();
+    this->outputs = this->outputBuffer.data();
+    return true;
+}
+
+template<typename T>
+bool BasicDataset<T>::map(const string& filename) {
+    MappedFile mapped;
+    BinaryDatasetHeader header;
+
+    if (!mapped.open(filename) || !readHeader(mapped, header) || header.scalarSize != sizeof(T))
+        return false;
+
+    this->clear();
+    this->file.swap(mapped);
+
+    this->numSamples = header.numSamples;
+    this->numInputs = header.numInputs;
+    this->numOutputs = header.numOutputs;
+    this->inputs = reinterpret_cast<const T*>(this->file.data() + header.inputsOffset);
+    this->outputs = reinterpret_cast<const T*>(this->file.data() + header.outputsOffset);
+    return true;
+}
+
+template<typename T>
+bool BasicDataset<T>::saveBinary(const string& filename) const {
+    size_t inputsSize = this->numSamples * this->numInputs * sizeof(T);
+    size_t outputsSize = this->numSamples * this->numOutputs * sizeof(T);
+
+    BinaryDatasetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_DATASET_MAGIC, sizeof(header.magic));
+    header.version = BINARY_DATASET_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.scalarSize = sizeof(T);
+    header.numSamples = this->numSamples;
+    header.numInputs = this->numInputs;
+    header.numOutputs = this->numOutputs;
+    header.inputsOffset = Arena::align(sizeof(header));
+    header.outputsOffset = Arena::align(header.inputsOffset + inputsSize);
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == 0)
+        return false;
+
+    vector<char> padding(Arena::ALIGNMENT, 0);
+    size_t inputsPadding = header.inputsOffset - sizeof(header);
+    size_t outputsPadding = header.outputsOffset - header.inputsOffset - inputsSize;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(padding.data(), 1, inputsPadding, file) == inputsPadding &&
+                   fwrite(this->inputs, 1, inputsSize, file) == inputsSize &&
+                   fwrite(padding.data(), 1, outputsPadding, file) == outputsPadding &&
+                   fwrite(this->outputs, 1, outputsSize, file) == outputsSize;
+
+    return fclose(file) == 0 && written;
+}
+
+template<typename T>
+bool BasicDataset<T>::isBinary(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == 0)
+        return false;
+
+    char magic[sizeof(BINARY_DATASET_MAGIC)];
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, BINARY_DATASET_MAGIC, sizeof(magic)) == 0;
+
+    fclose(file);
+    return binary;
+}
+
+template<typename T>
+size_t BasicDataset<T>::getNumSamples() const {
+    return this->numSamples;
+}
+
+template<typename T>
+size_t BasicDataset<T>::getNumInputs() const {
+    return this->numInputs;
+}
+
+template<typename T>
+size_t BasicDataset<T>::getNumOutputs() const {
+    return this->numOutputs;
+}
+
+template<typename T>
+const T* BasicDataset<T>::getInputs() const {
+    return this->inputs;
+}
+
+template<typename T>
+const T* BasicDataset<T>::getOutputs() const {
+    return this->outputs;
+}
+
+template<typename T>
+const T* BasicDataset<T>::getInputs(size_t sample) const {
+    return this->inputs + sample * this->numInputs;
+}
+
+template<typename T>
+const T* BasicDataset<T>::getOutputs(size_t sample) const {
+    return this->outputs + sample * this->numOutputs;
+}
+
+template<typename T>
+void BasicDataset<T>::clear() {
+    this->numSamples = 0;
+    this->numInputs = 0;
+    this->numOutputs = 0;
+    this->inputs = 0;
+    this->outputs = 0;
+
+    vector<T>().swap(this->inputBuffer);
+    vector<T>().swap(this->outputBuffer);
+    this->file.close();
+}
+
+template class BasicDataset<float>;
+template class BasicDataset<double>;
@@ -0,0 +1,106 @@
+/**
+* Dataset
+*
+* Training samples in two contiguous row-major matrices: the inputs (numSamples x numInputs) and
+* the expected outputs (numSamples x numOutputs). A dataset is read from a CSV file with one sample
+* per line, the input values followed by the output values, or from the packed binary format: a
+* 64 byte header followed by the input and the output matrix at 64 byte aligned offsets, stored in
+* the byte order of the writer. A binary dataset can be mapped into memory, so the training starts
+* without parsing and the pages are loaded on demand.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_DATASET_H
+#define _NEURAL_DATASET_H
+
+#include <iostream>
+#include <vector>
+
+#include "MappedFile.h"
+
+using namespace std;
+
+template<typename T>
+class BasicDataset {
+public:
+    BasicDataset();
+
+    /**
+    * Reads a CSV file with numInputs + numOutputs comma separated values per line. The file is
+    * read in chunks and the values are converted directly into the matrices. Empty lines and a
+    * header line at the beginning are skipped. Returns false if a line has the wrong number of
+    * values or the file can not be read.
+    */
+    bool loadCsv(const string& filename, size_t numInputs, size_t numOutputs);
+
+    /**
+    * Loads a binary dataset, converting between float and double if necessary
+    */
+    bool load(const string& filename);
+
+    /**
+    * Maps a binary dataset without copying it, the values must have the scalar type T
+    */
+    bool map(const string& filename);
+
+    /**
+    * Writes the dataset in the binary format
+    */
+    bool saveBinary(const string& filename) const;
+
+    /**
+    * Returns true if the file starts with the magic of the binary format
+    */
+    static bool isBinary(const string& filename);
+
+    size_t getNumSamples() const;
+    size_t getNumInputs() const;
+    size_t getNumOutputs() const;
+
+    /**
+    * Returns the input matrix (numSamples x numInputs)
+    */
+    const T* getInputs() const;
+
+    /**
+    * Returns the matrix of the expected outputs (numSamples x numOutputs)
+    */
+    const T* getOutputs() const;
+
+    /**
+    * Returns the input values of one sample
+    */
+    const T* getInputs(size_t sample) const;
+
+    /**
+    * Returns the expected output values of one sample
+    */
+    const T* getOutputs(size_t sample) const;
+
+private:
+    BasicDataset(const BasicDataset&);
+    BasicDataset& operator=(const BasicDataset&);
+
+    /**
+    * Releases the values and the mapped file
+    */
+    void clear();
+
+    size_t numSamples;
+    size_t numInputs;
+    size_t numOutputs;
+
+    // Point into the buffers or into the mapped file
+    const T* inputs;
+    const T* outputs;
+
+    vector<T> inputBuffer;
+    vector<T> outputBuffer;
+    MappedFile file;
+};
+
+typedef BasicDataset<double> Dataset;
+
+#endif
@@ -0,0 +1,179 @@
+/**
+* FixedNet
+*
+* A neural network for inference whose layer sizes are compile-time constants, e.g. FixedNet<2, 2, 1>
+* for the XOR network. The weights are stored in std::array members and every loop has a constant
+* trip count, so the compiler can unroll the whole forward pass and keep tiny networks in registers.
+* The weights are copied from a trained NeuralNet or InferenceNet with the same topology. Since the
+* sizes are template arguments, the implementation is part of the header.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_FIXED_NET_H
+#define _NEURAL_FIXED_NET_H
+
+#include <array>
+#include <iostream>
+#include <math.h>
+
+#include "InferenceNet.h"
+
+using namespace std;
+
+/**
+* The first value of a list of sizes
+*/
+template<size_t First, size_t... Rest>
+struct FirstSize {
+    static const size_t value = First;
+};
+
+/**
+* The last value of a list of sizes
+*/
+template<size_t First, size_t... Rest>
+struct LastSize {
+    static const size_t value = LastSize<Rest...>::value;
+};
+
+template<size_t Last>
+struct LastSize<Last> {
+    static const size_t value = Last;
+};
+
+/**
+* The weights of the layers following a layer with In neurons. Every layer is an Out x (In + 1)
+* matrix, the last column is the bias weight.
+*/
+template<typename T, size_t In, size_t... Sizes>
+struct FixedLayers {
+    /**
+    * Copies the weights of the layers from the given index on
+    */
+    template<typename Net>
+    bool assign(const Net&, size_t) {
+        return true;
+    }
+
+    /**
+    * Calculates the outputs of the remaining layers for the activations of the previous layer
+    */
+    void forward(const T* activations, T /* biasInput */, T* outputs) const {
+        for (size_t j = 0; j < In; ++j)
+            outputs[j] = activations[j];
+    }
+};
+
+template<typename T, size_t In, size_t Out, size_t... Rest>
+struct FixedLayers<T, In, Out, Rest...> {
+    array<T, Out * (In + 1)> weights;
+    FixedLayers<T, Out, Rest...> next;
+
+    template<typename Net>
+    bool assign(const Net& net, size_t index) {
+        const BasicLayer<T>& layer = net.getLayer(index);
+
+        if (layer.numNeurons != Out || layer.numInputs != (layer.hasBias ? In + 1 : In))
+            return false;
+
+        for (size_t j = 0; j < Out; ++j) {
+            const T* row = layer.weightsOf(j);
+
+            for (size_t k = 0; k < In; ++k)
+                this->weights[j * (In + 1) + k] = row[k];
+
+            // Layers without a bias get a bias weight of 0
+            this->weights[j * (In + 1) + In] = layer.hasBias ? row[In] : 0;
+        }
+
+        return this->next.assign(net, index + 1);
+    }
+
+    void forward(const T* activations, T biasInput, T* outputs) const {
+        T layerOutputs[Out];
+
+        for (size_t j = 0; j < Out; ++j) {
+            const T* row = &this->weights[j * (In + 1)];
+            T netInput = row[In] * biasInput;
+
+            for (size_t k = 0; k < In; ++k)
+                netInput += row[k] * activations[k];
+
+            layerOutputs[j] = 1 / (1 + exp(-netInput));
+        }
+
+        this->next.forward(layerOutputs, biasInput, outputs);
+    }
+};
+
+template<typename T, size_t... Sizes>
+class BasicFixedNet {
+    static_assert(sizeof...(Sizes) >= 2, "A network needs at least an input and an output layer");
+
+public:
+    static const size_t NUM_INPUTS = FirstSize<Sizes...>::value;
+    static const size_t NUM_OUTPUTS = LastSize<Sizes...>::value;
+
+    typedef array<T, NUM_INPUTS> Inputs;
+    typedef array<T, NUM_OUTPUTS> Outputs;
+
+    BasicFixedNet()
+        : layers(),
+          biasInput(0)
+    {
+    }
+
+    /**
+    * Copies the weights and the bias value of a NeuralNet or an InferenceNet. Returns false if the
+    * topology of the network does not match the template arguments.
+    */
+    template<typename Net>
+    bool assign(const Net& net) {
+        if (net.getNumLayers() != sizeof...(Sizes) || net.getLayer(0).numNeurons != NUM_INPUTS)
+            return false;
+
+        this->biasInput = net.getBiasStatus() ? net.getBiasValue() : 0;
+        return this->layers.assign(net, 1);
+    }
+
+    /**
+    * Loads the network from a JSON file written by NeuralNet::save()
+    */
+    bool load(const string& filename) {
+        BasicInferenceNet<T> net;
+        return net.load(filename) && this->assign(net);
+    }
+
+    /**
+    * Sends the signals (inputs) through the network and returns the output values
+    */
+    Outputs calculateOutputs(const Inputs& inputs) const {
+        Outputs outputs;
+        this->calculateOutputs(inputs.data(), outputs.data());
+        return outputs;
+    }
+
+    /**
+    * Sends NUM_INPUTS signals through the network and writes NUM_OUTPUTS values to outputs
+    */
+    void calculateOutputs(const T* inputs, T* outputs) const {
+        T activations[NUM_INPUTS];
+
+        // The input layer only applies the activation function
+        for (size_t k = 0; k < NUM_INPUTS; ++k)
+            activations[k] = 1 / (1 + exp(-inputs[k]));
+
+        this->layers.forward(activations, this->biasInput, outputs);
+    }
+
+private:
+    FixedLayers<T, Sizes...> layers;
+    T biasInput;
+};
+
+template<size_t... Sizes>
+using FixedNet = BasicFixedNet<double, Sizes...>;
+
+#endif
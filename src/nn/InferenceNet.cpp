@@ -0,0 +1,308 @@
+/**
+* InferenceNet
+*
+* The implementation of the frozen inference network.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "InferenceNet.h"
+#include "BinaryModel.h"
+#include "Kernels.h"
+#include "ModelReader.h"
+
+#include <algorithm>
+
+template<typename T>
+BasicInferenceNet<T>::BasicInferenceNet()
+    : biasValue(1),
+      useBias(true),
+      sigmoidMode(NeuralNetBase::EXACT),
+      maxNeurons(0)
+{
+}
+
+template<typename T>
+BasicInferenceNet<T>::BasicInferenceNet(const BasicNeuralNet<T>& net)
+    : biasValue(net.getBiasValue()),
+      useBias(net.getBiasStatus()),
+      sigmoidMode(net.getSigmoidMode()),
+      maxNeurons(0)
+{
+    vector<size_t> layerSizes;
+    vector<bool> layerBiases;
+
+    for (size_t i = 0; i < net.getNumLayers(); ++i) {
+        layerSizes.push_back(net.getLayer(i).numNeurons);
+        layerBiases.push_back(net.getLayer(i).hasBias);
+    }
+
+    this->allocate(layerSizes, layerBiases);
+
+    for (size_t i = 0; i < this->layers.size(); ++i) {
+        const BasicLayer<T>& source = net.getLayer(i);
+        copy(source.weights, source.weights + source.numWeights(), this->layers[i].weights);
+    }
+}
+
+template<typename T>
+BasicInferenceNet<T>::~BasicInferenceNet() {
+}
+
+template<typename T>
+void BasicInferenceNet<T>::createLayers(const vector<size_t>& layerSizes, const vector<bool>& layerBiases) {
+    this->layers.clear();
+    this->maxNeurons = 0;
+    this->arena.release();
+    this->file.close();
+
+    for (size_t i = 0; i < layerSizes.size(); ++i) {
+        size_t numInputs = i == 0 ? 0 : layerSizes[i - 1];
+        this->layers.push_back(BasicLayer<T>(layerSizes[i], numInputs, layerBiases[i]));
+        this->maxNeurons = max(this->maxNeurons, layerSizes[i]);
+    }
+}
+
+template<typename T>
+void BasicInferenceNet<T>::allocate(const vector<size_t>& layerSizes, const vector<bool>& layerBiases) {
+    this->createLayers(layerSizes, layerBiases);
+
+    // Only the weights are stored, every layer starts at a cache line boundary
+    size_t numBytes = 0;
+    for (const BasicLayer<T>& layer : this->layers)
+        numBytes += Arena::align(layer.numWeights() * sizeof(T));
+
+    this->arena.allocate(numBytes);
+
+    char* weights = this->arena.data();
+    for (BasicLayer<T>& layer : this->layers) {
+        layer.bind(reinterpret_cast<T*>(weights), 0, 0, 0);
+        weights += Arena::align(layer.numWeights() * sizeof(T));
+    }
+}
+
+template<typename T>
+bool BasicInferenceNet<T>::load(const string& filename) {
+    if (isBinaryModel(filename))
+        return this->loadBinary(filename);
+
+    ModelReader reader;
+    if (!reader.open(filename))
+        return false;
+
+    // The weights are converted into temporary buffers first, so a file which turns out to be
+    // malformed in the second pass leaves the network unchanged (like NeuralNet::load)
+    const ModelTopology& topology = reader.getTopology();
+    vector<vector<T>> weights(topology.layerSizes.size());
+    vector<T*> layerWeights;
+
+    for (size_t i = 0; i < topology.layerSizes.size(); ++i) {
+        size_t numInputs = i == 0 ? 0 : topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0);
+        weights[i].resize(topology.layerSizes[i] * numInputs);
+        layerWeights.push_back(weights[i].data());
+    }
+
+    if (!reader.readWeights(layerWeights))
+        return false;
+
+    this->biasValue = (T) topology.biasValue;
+    this->useBias = topology.useBias;
+    this->allocate(topology.layerSizes, topology.layerBiases);
+
+    for (size_t i = 0; i < this->layers.size(); ++i)
+        copy(weights[i].begin(), weights[i].end(), this->layers[i].weights);
+
+    return true;
+}
+
+template<typename T>
+bool BasicInferenceNet<T>::loadBinary(const string& filename) {
+    MappedFile file;
+    BinaryModelHeader header;
+    ModelTopology topology;
+
+    if (!file.open(filename) || !readBinaryModel(file.data(), file.size(), header, topology))
+        return false;
+
+    this->biasValue = (T) topology.biasValue;
+    this->useBias = topology.useBias;
+    this->allocate(topology.layerSizes, topology.layerBiases);
+
+    vector<T*> layerWeights;
+    for (BasicLayer<T>& layer : this->layers)
+        layerWeights.push_back(layer.weights);
+
+    readBinaryModelSection(file.data() + header.weightsOffset, topology, header.scalarSize, layerWeights);
+    return true;
+}
+
+template<typename T>
+bool BasicInferenceNet<T>::map(const string& filename) {
+    MappedFile mapped;
+    BinaryModelHeader header;
+    ModelTopology topology;
+
+    if (!mapped.open(filename) || !readBinaryModel(mapped.data(), mapped.size(), header, topology) ||
+        header.scalarSize != sizeof(T))
+        return false;
+
+    this->biasValue = (T) topology.biasValue;
+    this->useBias = topology.useBias;
+    this->createLayers(topology.layerSizes, topology.layerBiases);
+
+    // The layers point into the read-only mapping, the weights are never written
+    const char* weights = mapped.data() + header.weightsOffset;
+    for (BasicLayer<T>& layer : this->layers) {
+        layer.bind(const_cast<T*>(reinterpret_cast<const T*>(weights)), 0, 0, 0);
+        weights += Arena::align(layer.numWeights() * sizeof(T));
+    }
+
+    this->file.swap(mapped);
+    return true;
+}
+
+template<typename T>
+void BasicInferenceNet<T>::activate(size_t n, const T* netInputs, T* activations) const {
+    if (this->sigmoidMode == NeuralNetBase::FAST)
+        sigmoidFast(n, netInputs, activations);
+    else if (this->sigmoidMode == NeuralNetBase::TABLE)
+        sigmoidTable(n, netInputs, activations);
+    else
+        sigmoidExact(n, netInputs, activations);
+}
+
+template<typename T>
+void BasicInferenceNet<T>::calculateOutputs(const T* inputs, T* outputs, T* scratch) const {
+    // The layers write alternately into the two halves of the scratch memory
+    T* buffers[2] = { scratch, scratch + this->maxNeurons };
+
+    // The input layer only applies the activation function
+    this->activate(this->layers[0].numNeurons, inputs, buffers[0]);
+
+    for (size_t i = 1; i < this->layers.size(); ++i) {
+        const BasicLayer<T>& li = this->layers[i];
+        const T* layerInputs = buffers[(i - 1) % 2];
+        T* netInputs = i + 1 == this->layers.size() ? outputs : buffers[i % 2];
+
+        gemv(li.numNeurons, this->layers[i - 1].numNeurons, 1, li.weights, li.numInputs, layerInputs, 0, netInputs);
+
+        // Add the bias value if enabled
+        if (this->useBias && li.hasBias) {
+            for (size_t j = 0; j < li.numNeurons; ++j)
+                netInputs[j] += li.weightsOf(j)[li.numInputs - 1] * this->biasValue;
+        }
+
+        this->activate(li.numNeurons, netInputs, netInputs);
+    }
+}
+
+template<typename T>
+void BasicInferenceNet<T>::calculateOutputs(const T* inputs, T* outputs) const {
+    static thread_local vector<T> scratch;
+
+    if (scratch.size() < this->getScratchSize())
+        scratch.resize(this->getScratchSize());
+
+    this->calculateOutputs(inputs, outputs, scratch.data());
+}
+
+template<typename T>
+vector<T> BasicInferenceNet<T>::calculateOutputs(const vector<T>& inputs) const {
+    // Check the size of the inputs
+    if (inputs.size() != this->getNumInputs())
+        return vector<T>();
+
+    vector<T> outputs(this->getNumOutputs());
+    this->calculateOutputs(inputs.data(), outputs.data());
+    return outputs;
+}
+
+template<typename T>
+void BasicInferenceNet<T>::calculateOutputsBatch(const T* inputs, size_t batchSize, T* outputs) const {
+    static thread_local vector<T> scratch;
+
+    if (scratch.size() < 2 * batchSize * this->maxNeurons)
+        scratch.resize(2 * batchSize * this->maxNeurons);
+
+    T* buffers[2] = { scratch.data(), scratch.data() + batchSize * this->maxNeurons };
+
+    // The input layer only applies the activation function
+    this->activate(batchSize * this->layers[0].numNeurons, inputs, buffers[0]);
+
+    for (size_t i = 1; i < this->layers.size(); ++i) {
+        const BasicLayer<T>& li = this->layers[i];
+        size_t numInputs = this->layers[i - 1].numNeurons;
+        const T* layerInputs = buffers[(i - 1) % 2];
+        T* netInputs = i + 1 == this->layers.size() ? outputs : buffers[i % 2];
+
+        // Net inputs (batchSize x numNeurons) = inputs (batchSize x numInputs) * weights^T
+        gemm(false, true, batchSize, li.numNeurons, numInputs, 1, layerInputs, numInputs, li.weights, li.numInputs, 0,
+             netInputs, li.numNeurons);
+
+        // Add the bias value if enabled
+        if (this->useBias && li.hasBias) {
+            for (size_t b = 0; b < batchSize; ++b) {
+                T* row = netInputs + b * li.numNeurons;
+
+                for (size_t j = 0; j < li.numNeurons; ++j)
+                    row[j] += li.weightsOf(j)[li.numInputs - 1] * this->biasValue;
+            }
+        }
+
+        this->activate(batchSize * li.numNeurons, netInputs, netInputs);
+    }
+}
+
+template<typename T>
+size_t BasicInferenceNet<T>::getScratchSize() const {
+    return 2 * this->maxNeurons;
+}
+
+template<typename T>
+void BasicInferenceNet<T>::setSigmoidMode(NeuralNetBase::SigmoidMode mode) {
+    this->sigmoidMode = mode;
+}
+
+template<typename T>
+NeuralNetBase::SigmoidMode BasicInferenceNet<T>::getSigmoidMode() const {
+    return this->sigmoidMode;
+}
+
+template<typename T>
+T BasicInferenceNet<T>::getBiasValue() const {
+    return this->biasValue;
+}
+
+template<typename T>
+bool BasicInferenceNet<T>::getBiasStatus() const {
+    return this->useBias;
+}
+
+template<typename T>
+size_t BasicInferenceNet<T>::getNumLayers() const {
+    return this->layers.size();
+}
+
+template<typename T>
+const BasicLayer<T>& BasicInferenceNet<T>::getLayer(size_t index) const {
+    return this->layers[index];
+}
+
+template<typename T>
+size_t BasicInferenceNet<T>::getNumInputs() const {
+    return this->layers.empty() ? 0 : this->layers.front().numNeurons;
+}
+
+template<typename T>
+size_t BasicInferenceNet<T>::getNumOutputs() const {
+    return this->layers.empty() ? 0 : this->layers.back().numNeurons;
+}
+
+template<typename T>
+const Arena& BasicInferenceNet<T>::getArena() const {
+    return this->arena;
+}
+
+template class BasicInferenceNet<float>;
+template class BasicInferenceNet<double>;
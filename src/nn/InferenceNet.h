@@ -0,0 +1,165 @@
+/**
+* InferenceNet
+*
+* A frozen neural network for inference. It holds only the packed weights of a trained network,
+* without the delta weights, net inputs and activations of the training, so it needs about half
+* the memory of a NeuralNet. The forward pass is const and works on scratch memory of the caller
+* (or of the calling thread), so one network can be used by several threads at the same time.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_INFERENCE_NET_H
+#define _NEURAL_INFERENCE_NET_H
+
+#include <iostream>
+#include <vector>
+
+#include "Arena.h"
+#include "Layer.h"
+#include "MappedFile.h"
+#include "NeuralNet.h"
+
+using namespace std;
+
+template<typename T>
+class BasicInferenceNet {
+public:
+    /**
+    * Creates an empty network, see load()
+    */
+    BasicInferenceNet();
+
+    /**
+    * Copies the weights, the bias settings and the sigmoid mode of a trained network
+    */
+    BasicInferenceNet(const BasicNeuralNet<T>& net);
+
+    ~BasicInferenceNet();
+
+    /**
+    * Loads the network from a JSON file written by NeuralNet::save() or a binary file written by
+    * NeuralNet::saveBinary(). If the file can not be read, false is returned and the network is
+    * left unchanged.
+    */
+    bool load(const string& filename);
+
+    /**
+    * Maps a binary file written by NeuralNet::saveBinary() into memory and uses the weights in the
+    * mapping without copying them. The file must have the scalar type of the network. Loading is
+    * independent of the model size and all processes mapping the same file share its pages.
+    */
+    bool map(const string& filename);
+
+    /**
+    * Sends the signals (inputs) through the network and writes the output values to outputs.
+    * scratch must hold getScratchSize() values.
+    */
+    void calculateOutputs(const T* inputs, T* outputs, T* scratch) const;
+
+    /**
+    * Sends the signals (inputs) through the network and writes the output values to outputs,
+    * using scratch memory of the calling thread
+    */
+    void calculateOutputs(const T* inputs, T* outputs) const;
+
+    /**
+    * Sends the signals (inputs) through the network and returns the output values
+    */
+    vector<T> calculateOutputs(const vector<T>& inputs) const;
+
+    /**
+    * Sends a batch of signals (a row-major batchSize x inputs matrix) through the network and writes
+    * the batchSize x outputs results to outputs. Every layer is one matrix-matrix product, the
+    * intermediate results are kept in scratch memory of the calling thread.
+    */
+    void calculateOutputsBatch(const T* inputs, size_t batchSize, T* outputs) const;
+
+    /**
+    * Returns the number of values the scratch memory of calculateOutputs must hold
+    */
+    size_t getScratchSize() const;
+
+    /**
+    * Selects how the sigmoid function is evaluated
+    */
+    void setSigmoidMode(NeuralNetBase::SigmoidMode mode);
+
+    /**
+    * Returns how the sigmoid function is evaluated
+    */
+    NeuralNetBase::SigmoidMode getSigmoidMode() const;
+
+    /**
+    * Returns the bias value
+    */
+    T getBiasValue() const;
+
+    /**
+    * Returns true if the bias value is enabled
+    */
+    bool getBiasStatus() const;
+
+    /**
+    * Returns the number of layers including the input and the output layer
+    */
+    size_t getNumLayers() const;
+
+    /**
+    * Returns the layer with the given index (0 is the input layer), only its weights are set
+    */
+    const BasicLayer<T>& getLayer(size_t index) const;
+
+    /**
+    * Returns the number of neurons of the input layer
+    */
+    size_t getNumInputs() const;
+
+    /**
+    * Returns the number of neurons of the output layer
+    */
+    size_t getNumOutputs() const;
+
+    /**
+    * Returns the arena which holds the weights (empty if the weights are mapped)
+    */
+    const Arena& getArena() const;
+
+private:
+    BasicInferenceNet(const BasicInferenceNet&);
+    BasicInferenceNet& operator=(const BasicInferenceNet&);
+
+    /**
+    * Creates the layers with the given number of neurons and bias flags without weights
+    */
+    void createLayers(const vector<size_t>& layerSizes, const vector<bool>& layerBiases);
+
+    /**
+    * Creates the layers and places their weights in the arena
+    */
+    void allocate(const vector<size_t>& layerSizes, const vector<bool>& layerBiases);
+
+    /**
+    * Loads a file in the binary model format into the arena
+    */
+    bool loadBinary(const string& filename);
+
+    /**
+    * Applies the sigmoid function to n net inputs
+    */
+    void activate(size_t n, const T* netInputs, T* activations) const;
+
+    T biasValue;
+    bool useBias;
+    NeuralNetBase::SigmoidMode sigmoidMode;
+
+    vector<BasicLayer<T>> layers;
+    size_t maxNeurons;
+    Arena arena;
+    MappedFile file;
+};
+
+typedef BasicInferenceNet<double> InferenceNet;
+
+#endif
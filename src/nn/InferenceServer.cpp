@@ -0,0 +1,322 @@
+/**
+* InferenceServer
+*
+* The implementation of the dynamic-batching inference server.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "InferenceServer.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+* The longest input value expected in a request ("%.17g" of a double plus separators), requests
+* may be MAX_LINE_FACTOR times longer than numInputs values of this length
+*/
+static const size_t MAX_VALUE_LENGTH = 32;
+static const size_t MAX_LINE_FACTOR = 4;
+
+/**
+* Reads the next line from fd into line, buffer keeps the data read behind the line.
+* Returns false at the end of the input or if a line is longer than maxLength.
+*/
+static bool readLine(int fd, size_t maxLength, string& buffer, string& line) {
+    char data[4096];
+
+    while (true) {
+        size_t end = buffer.find('\n');
+
+        if (end != string::npos && end <= maxLength) {
+            line.assign(buffer, 0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+
+        // A client sending endless lines must not exhaust the memory of the server
+        if (end != string::npos || buffer.size() > maxLength)
+            return false;
+
+        ssize_t numBytes = read(fd, data, sizeof(data));
+
+        if (numBytes < 0 && errno == EINTR)
+            continue;
+
+        // The last line may end without a line break
+        if (numBytes <= 0) {
+            line.swap(buffer);
+            buffer.clear();
+            return !line.empty();
+        }
+
+        buffer.append(data, numBytes);
+    }
+}
+
+/**
+* Writes the whole string to fd, returns false if the other side closed the connection
+*/
+static bool writeAll(int fd, const string& data) {
+    size_t written = 0;
+
+    while (written < data.size()) {
+        ssize_t numBytes = write(fd, data.data() + written, data.size() - written);
+
+        if (numBytes < 0 && errno == EINTR)
+            continue;
+        if (numBytes <= 0)
+            return false;
+
+        written += numBytes;
+    }
+
+    return true;
+}
+
+/**
+* Parses the values of a request separated by spaces, tabs or commas. Returns false if the line
+* contains something else than numbers.
+*/
+static bool parseValues(const string& line, vector<double>& values) {
+    const char* position = line.c_str();
+    values.clear();
+
+    while (true) {
+        while (*position == ' ' || *position == '\t' || *position == ',' || *position == '\r')
+            position++;
+
+        if (*position == 0)
+            return true;
+
+        char* end;
+        values.push_back(strtod(position, &end));
+
+        if (end == position)
+            return false;
+
+        position = end;
+    }
+}
+
+InferenceServer::InferenceServer(const InferenceNet& net, size_t maxBatchSize, size_t maxDelay)
+    : net(net),
+      maxBatchSize(max(maxBatchSize, size_t(1))),
+      maxDelay(maxDelay),
+      stopped(false)
+{
+    this->batcher = thread(&InferenceServer::runBatches, this);
+}
+
+InferenceServer::~InferenceServer() {
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopped = true;
+    }
+
+    this->arrived.notify_all();
+    this->batcher.join();
+}
+
+future<vector<double>> InferenceServer::submit(vector<double>& inputs) {
+    Request request;
+    request.inputs.swap(inputs);
+    request.arrival = Clock::now();
+    future<vector<double>> outputs = request.outputs.get_future();
+
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->requests.push_back(move(request));
+    }
+
+    this->arrived.notify_one();
+    return outputs;
+}
+
+void InferenceServer::runBatches() {
+    size_t numInputs = this->net.getNumInputs();
+    size_t numOutputs = this->net.getNumOutputs();
+    vector<Request> batch;
+
+    while (true) {
+        {
+            unique_lock<mutex> guard(this->lock);
+
+            while (!this->stopped && this->requests.empty())
+                this->arrived.wait(guard);
+
+            if (this->requests.empty())
+                return;
+
+            // Collect more requests until the batch is full or the oldest request used up its latency budget
+            Clock::time_point deadline = this->requests.front().arrival + this->maxDelay;
+
+            while (!this->stopped && this->requests.size() < this->maxBatchSize && Clock::now() < deadline)
+                this->arrived.wait_until(guard, deadline);
+
+            size_t batchSize = min(this->requests.size(), this->maxBatchSize);
+            batch.clear();
+
+            for (size_t i = 0; i < batchSize; ++i) {
+                batch.push_back(move(this->requests.front()));
+                this->requests.pop_front();
+            }
+        }
+
+        // One batched forward pass for all requests
+        this->batchInputs.resize(batch.size() * numInputs);
+        this->batchOutputs.resize(batch.size() * numOutputs);
+
+        for (size_t i = 0; i < batch.size(); ++i)
+            copy(batch[i].inputs.begin(), batch[i].inputs.end(), &this->batchInputs[i * numInputs]);
+
+        this->net.calculateOutputsBatch(this->batchInputs.data(), batch.size(), this->batchOutputs.data());
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const double* outputs = &this->batchOutputs[i * numOutputs];
+            batch[i].outputs.set_value(vector<double>(outputs, outputs + numOutputs));
+        }
+    }
+}
+
+void InferenceServer::serve(int inFd, int outFd) {
+    size_t numInputs = this->net.getNumInputs();
+
+    // The responses are written by a second thread, so the requests of one connection can be batched
+    deque<future<vector<double>>> pending;
+    mutex pendingLock;
+    condition_variable pendingChanged;
+    bool finished = false;
+
+    thread writer([&] {
+        char number[32];
+        string response;
+
+        while (true) {
+            future<vector<double>> outputs;
+
+            {
+                unique_lock<mutex> guard(pendingLock);
+
+                while (!finished && pending.empty())
+                    pendingChanged.wait(guard);
+
+                if (pending.empty())
+                    return;
+
+                outputs = move(pending.front());
+                pending.pop_front();
+            }
+
+            vector<double> values = outputs.get();
+            response.clear();
+
+            if (values.empty()) {
+                snprintf(number, sizeof(number), "%zu", numInputs);
+                response = string("error: expected ") + number + " input values";
+            }
+
+            for (size_t i = 0; i < values.size(); ++i) {
+                snprintf(number, sizeof(number), i == 0 ? "%.17g" : " %.17g", values[i]);
+                response += number;
+            }
+
+            response += '\n';
+
+            // Keep draining the results if the client is gone
+            writeAll(outFd, response);
+        }
+    });
+
+    string buffer, line;
+    vector<double> inputs;
+    size_t maxLength = MAX_LINE_FACTOR * (numInputs + 1) * MAX_VALUE_LENGTH;
+
+    // The connection is closed after a line which is too long
+    while (readLine(inFd, maxLength, buffer, line)) {
+        bool valid = parseValues(line, inputs);
+
+        if (valid && inputs.empty())
+            continue;
+
+        future<vector<double>> outputs;
+
+        if (valid && inputs.size() == numInputs) {
+            outputs = this->submit(inputs);
+        } else {
+            // Invalid requests are answered in order with an error
+            promise<vector<double>> error;
+            error.set_value(vector<double>());
+            outputs = error.get_future();
+        }
+
+        lock_guard<mutex> guard(pendingLock);
+        pending.push_back(move(outputs));
+        pendingChanged.notify_one();
+    }
+
+    {
+        lock_guard<mutex> guard(pendingLock);
+        finished = true;
+    }
+
+    pendingChanged.notify_one();
+    writer.join();
+}
+
+bool InferenceServer::listen(const string& socketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Socket path too long: " << socketPath << endl;
+        return false;
+    }
+
+    strcpy(address.sun_path, socketPath.c_str());
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        cerr << "Could not create socket: " << strerror(errno) << endl;
+        return false;
+    }
+
+    // Replace the socket of a previous run
+    unlink(socketPath.c_str());
+
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(server, SOMAXCONN) < 0) {
+        cerr << "Could not listen on " << socketPath << ": " << strerror(errno) << endl;
+        close(server);
+        return false;
+    }
+
+    // Writing to a closed connection must not terminate the server
+    signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        int client = accept(server, 0, 0);
+
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            cerr << "Could not accept a connection: " << strerror(errno) << endl;
+            close(server);
+            return false;
+        }
+
+        thread([this, client] {
+            this->serve(client, client);
+            close(client);
+        }).detach();
+    }
+}
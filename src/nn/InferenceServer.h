@@ -0,0 +1,89 @@
+/**
+* InferenceServer
+*
+* Serves an InferenceNet over a Unix domain socket or a pair of file descriptors (e.g. stdin and
+* stdout). Every request is one line of input values separated by spaces or commas, the response is
+* one line with the output values in the same order as the requests of the connection. Requests of
+* all connections are coalesced into micro-batches: a batch is run through the batched forward pass
+* once it holds maxBatchSize requests or its oldest request has waited maxDelay microseconds.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_INFERENCE_SERVER_H
+#define _NEURAL_INFERENCE_SERVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "InferenceNet.h"
+
+using namespace std;
+
+class InferenceServer {
+public:
+    /**
+    * Creates a server for the given network, which must outlive the server
+    */
+    InferenceServer(const InferenceNet& net, size_t maxBatchSize, size_t maxDelay);
+    ~InferenceServer();
+
+    /**
+    * Listens on a Unix domain socket and serves every connection in its own thread. Only returns if
+    * the socket can not be created.
+    */
+    bool listen(const string& socketPath);
+
+    /**
+    * Reads requests from inFd and writes the responses to outFd until the end of the input or
+    * until a line is longer than a few times the expected length of numInputs values
+    */
+    void serve(int inFd, int outFd);
+
+private:
+    InferenceServer(const InferenceServer&);
+    InferenceServer& operator=(const InferenceServer&);
+
+    typedef chrono::steady_clock Clock;
+
+    /**
+    * A request waiting for its batch
+    */
+    struct Request {
+        vector<double> inputs;
+        promise<vector<double>> outputs;
+        Clock::time_point arrival;
+    };
+
+    /**
+    * Queues a request and returns the future of its output values
+    */
+    future<vector<double>> submit(vector<double>& inputs);
+
+    /**
+    * The loop of the batching thread: collect a batch, run it, repeat
+    */
+    void runBatches();
+
+    const InferenceNet& net;
+    size_t maxBatchSize;
+    chrono::microseconds maxDelay;
+
+    mutex lock;
+    condition_variable arrived;
+    deque<Request> requests;
+    bool stopped;
+
+    vector<double> batchInputs;
+    vector<double> batchOutputs;
+    thread batcher;
+};
+
+#endif
@@ -0,0 +1,318 @@
+/**
+* Kernels
+*
+* The implementation of the linear algebra kernels.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Kernels.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+using namespace std;
+
+// Register tile of the gemm micro-kernel (MR x NR accumulators)
+static const size_t MR = 4;
+static const size_t NR = 4;
+
+// Cache blocks: an MC x KC panel of A stays in L2, a KC x NR sliver of B in L1
+static const size_t MC = 64;
+static const size_t KC = 256;
+static const size_t NC = 1024;
+
+// Sigmoid lookup table: SIGMOID_TABLE_SIZE values over [-SIGMOID_TABLE_RANGE, SIGMOID_TABLE_RANGE]
+static const size_t SIGMOID_TABLE_SIZE = 4096;
+static const double SIGMOID_TABLE_RANGE = 16;
+
+// Column block of gemvTransposed so that the touched part of y stays in L1
+static const size_t GEMV_COLUMN_BLOCK = 1024;
+
+template<typename T>
+T dot(size_t n, const T* x, const T* y) {
+    return simdKernels<T>().dot(n, x, y);
+}
+
+template<typename T>
+void axpy(size_t n, typename Scalar<T>::Type alpha, const T* x, T* y) {
+    simdKernels<T>().axpy(n, alpha, x, y);
+}
+
+template<typename T>
+void scale(size_t n, typename Scalar<T>::Type alpha, T* x) {
+    if (alpha == 0) {
+        fill(x, x + n, T(0));
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        x[i] *= alpha;
+}
+
+template<typename T>
+void momentumUpdate(size_t n, typename Scalar<T>::Type alpha, const T* x, typename Scalar<T>::Type beta, T* d, T* w) {
+    simdKernels<T>().update(n, alpha, x, beta, d, w);
+}
+
+template<typename T>
+void sigmoidExact(size_t n, const T* x, T* y) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] = 1 / (1 + exp(-x[i]));
+}
+
+template<typename T>
+void sigmoidFast(size_t n, const T* x, T* y) {
+    simdKernels<T>().sigmoid(n, x, y);
+}
+
+/**
+* Returns the sigmoid table. One additional value at the end lets the interpolation read
+* index + 1 without a check when x is clamped to the upper end of the range.
+*/
+template<typename T>
+static const vector<T>& sigmoidTableValues() {
+    static const vector<T> table = [] {
+        vector<T> values(SIGMOID_TABLE_SIZE + 1);
+        double step = 2 * SIGMOID_TABLE_RANGE / (SIGMOID_TABLE_SIZE - 1);
+
+        for (size_t i = 0; i < SIGMOID_TABLE_SIZE; ++i)
+            values[i] = 1 / (1 + exp(-(-SIGMOID_TABLE_RANGE + i * step)));
+
+        values[SIGMOID_TABLE_SIZE] = values[SIGMOID_TABLE_SIZE - 1];
+        return values;
+    }();
+
+    return table;
+}
+
+template<typename T>
+void sigmoidTable(size_t n, const T* x, T* y) {
+    const T scale = (SIGMOID_TABLE_SIZE - 1) / (2 * SIGMOID_TABLE_RANGE);
+    simdKernels<T>().interpolate(n, sigmoidTableValues<T>().data(), SIGMOID_TABLE_SIZE, (T) -SIGMOID_TABLE_RANGE,
+                                 scale, x, y);
+}
+
+template<typename T>
+void gemv(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* A, size_t lda, const T* x,
+          typename Scalar<T>::Type beta, T* y) {
+    const SimdKernels<T>& kernels = simdKernels<T>();
+    size_t i = 0;
+
+    // Four rows at once so that every element of x is loaded once per four rows
+    for (; i + 4 <= rows; i += 4) {
+        const T* a0 = A + i * lda;
+        const T* a1 = a0 + lda;
+        const T* a2 = a1 + lda;
+        const T* a3 = a2 + lda;
+        T sums[4];
+
+        kernels.dot4(cols, a0, a1, a2, a3, x, sums);
+
+        for (size_t r = 0; r < 4; ++r)
+            y[i + r] = alpha * sums[r] + (beta == 0 ? 0 : beta * y[i + r]);
+    }
+
+    for (; i < rows; ++i)
+        y[i] = alpha * kernels.dot(cols, A + i * lda, x) + (beta == 0 ? 0 : beta * y[i]);
+}
+
+template<typename T>
+void gemvTransposed(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* A, size_t lda, const T* x,
+                    typename Scalar<T>::Type beta, T* y) {
+    if (beta != 1)
+        scale(cols, beta, y);
+
+    for (size_t c0 = 0; c0 < cols; c0 += GEMV_COLUMN_BLOCK) {
+        size_t nc = min(GEMV_COLUMN_BLOCK, cols - c0);
+        T* yc = y + c0;
+
+        size_t i = 0;
+
+        // Four rows at once so that every element of y is read and written once per four rows
+        for (; i + 4 <= rows; i += 4) {
+            const T* a0 = A + i * lda + c0;
+            const T* a1 = a0 + lda;
+            const T* a2 = a1 + lda;
+            const T* a3 = a2 + lda;
+            T x0 = alpha * x[i], x1 = alpha * x[i + 1], x2 = alpha * x[i + 2], x3 = alpha * x[i + 3];
+
+            for (size_t k = 0; k < nc; ++k)
+                yc[k] += x0 * a0[k] + x1 * a1[k] + x2 * a2[k] + x3 * a3[k];
+        }
+
+        for (; i < rows; ++i)
+            axpy(nc, alpha * x[i], A + i * lda + c0, yc);
+    }
+}
+
+template<typename T>
+void ger(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* x, const T* y, T* A, size_t lda) {
+    for (size_t i = 0; i < rows; ++i)
+        axpy(cols, alpha * x[i], y, A + i * lda);
+}
+
+template<typename T>
+void gerMomentumUpdate(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* x, const T* y,
+                       typename Scalar<T>::Type beta, T* D, T* W, size_t ld) {
+    const SimdKernels<T>& kernels = simdKernels<T>();
+
+    for (size_t i = 0; i < rows; ++i)
+        kernels.update(cols, alpha * x[i], y, beta, D + i * ld, W + i * ld);
+}
+
+/**
+* Packs the mc x kc block of op(A) starting at (i0, p0) into row panels of MR rows. Within a panel
+* the MR values of one column are adjacent. Missing rows at the border are filled with zeros.
+*/
+template<typename T>
+static void packA(bool transA, const T* A, size_t lda, size_t i0, size_t p0, size_t mc, size_t kc, T* packed) {
+    for (size_t ir = 0; ir < mc; ir += MR) {
+        size_t mr = min(MR, mc - ir);
+
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t r = 0; r < MR; ++r) {
+                size_t i = i0 + ir + r, k = p0 + p;
+                *packed++ = r < mr ? (transA ? A[k * lda + i] : A[i * lda + k]) : 0;
+            }
+        }
+    }
+}
+
+/**
+* Packs the kc x nc block of op(B) starting at (p0, j0) into column panels of NR columns. Within a
+* panel the NR values of one row are adjacent. Missing columns at the border are filled with zeros.
+*/
+template<typename T>
+static void packB(bool transB, const T* B, size_t ldb, size_t p0, size_t j0, size_t kc, size_t nc, T* packed) {
+    for (size_t jr = 0; jr < nc; jr += NR) {
+        size_t nr = min(NR, nc - jr);
+
+        for (size_t p = 0; p < kc; ++p) {
+            for (size_t c = 0; c < NR; ++c) {
+                size_t j = j0 + jr + c, k = p0 + p;
+                *packed++ = c < nr ? (transB ? B[j * ldb + k] : B[k * ldb + j]) : 0;
+            }
+        }
+    }
+}
+
+/**
+* C[0:mr, 0:nr] += alpha * Apanel * Bpanel with the MR x NR accumulators kept in registers
+*/
+template<typename T>
+static void microKernel(size_t kc, T alpha, const T* a, const T* b, T* C, size_t ldc, size_t mr, size_t nr) {
+    T c[MR][NR] = { { 0 } };
+
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t r = 0; r < MR; ++r) {
+            for (size_t s = 0; s < NR; ++s)
+                c[r][s] += a[r] * b[s];
+        }
+
+        a += MR;
+        b += NR;
+    }
+
+    for (size_t r = 0; r < mr; ++r) {
+        for (size_t s = 0; s < nr; ++s)
+            C[r * ldc + s] += alpha * c[r][s];
+    }
+}
+
+template<typename T>
+void gemm(bool transA, bool transB, size_t M, size_t N, size_t K, typename Scalar<T>::Type alpha, const T* A,
+          size_t lda, const T* B, size_t ldb, typename Scalar<T>::Type beta, T* C, size_t ldc) {
+    if (beta != 1) {
+        for (size_t i = 0; i < M; ++i)
+            scale(N, beta, C + i * ldc);
+    }
+
+    if (alpha == 0 || K == 0)
+        return;
+
+    // The packing buffers are kept per thread and only grow
+    static thread_local vector<T> packedA, packedB;
+    size_t sizeA = ((min(MC, M) + MR - 1) / MR) * MR * min(KC, K);
+    size_t sizeB = ((min(NC, N) + NR - 1) / NR) * NR * min(KC, K);
+    if (packedA.size() < sizeA)
+        packedA.resize(sizeA);
+    if (packedB.size() < sizeB)
+        packedB.resize(sizeB);
+
+    for (size_t jc = 0; jc < N; jc += NC) {
+        size_t nc = min(NC, N - jc);
+
+        for (size_t pc = 0; pc < K; pc += KC) {
+            size_t kc = min(KC, K - pc);
+            packB(transB, B, ldb, pc, jc, kc, nc, packedB.data());
+
+            for (size_t ic = 0; ic < M; ic += MC) {
+                size_t mc = min(MC, M - ic);
+                packA(transA, A, lda, ic, pc, mc, kc, packedA.data());
+
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    const T* b = packedB.data() + jr * kc;
+
+                    for (size_t ir = 0; ir < mc; ir += MR) {
+                        const T* a = packedA.data() + ir * kc;
+                        T* c = C + (ic + ir) * ldc + jc + jr;
+                        microKernel(kc, alpha, a, b, c, ldc, min(MR, mc - ir), min(NR, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void gemvInt8(size_t rows, size_t cols, const int8_t* A, size_t lda, const uint8_t* x, int32_t* y) {
+    const SimdInt8Kernels& kernels = simdInt8Kernels();
+    size_t i = 0;
+
+    // Four rows at once so that every element of x is loaded once per four rows
+    for (; i + 4 <= rows; i += 4) {
+        const int8_t* a0 = A + i * lda;
+        kernels.dot4(cols, a0, a0 + lda, a0 + 2 * lda, a0 + 3 * lda, x, y + i);
+    }
+
+    for (; i < rows; ++i)
+        y[i] = kernels.dot(cols, A + i * lda, x);
+}
+
+void gemmInt8(size_t M, size_t N, size_t K, const int8_t* A, size_t lda, const uint8_t* B, size_t ldb, int32_t* C,
+              size_t ldc) {
+    const SimdInt8Kernels& kernels = simdInt8Kernels();
+    size_t i = 0;
+
+    for (; i + 4 <= M; i += 4) {
+        const int8_t* a0 = A + i * lda;
+
+        for (size_t j = 0; j < N; ++j)
+            kernels.dot4(K, a0, a0 + lda, a0 + 2 * lda, a0 + 3 * lda, B + j * ldb, C + j * ldc + i);
+    }
+
+    for (; i < M; ++i) {
+        for (size_t j = 0; j < N; ++j)
+            C[j * ldc + i] = kernels.dot(K, A + i * lda, B + j * ldb);
+    }
+}
+
+#define NN_INSTANTIATE_KERNELS(T) \
+    template T dot<T>(size_t, const T*, const T*); \
+    template void axpy<T>(size_t, T, const T*, T*); \
+    template void scale<T>(size_t, T, T*); \
+    template void momentumUpdate<T>(size_t, T, const T*, T, T*, T*); \
+    template void sigmoidExact<T>(size_t, const T*, T*); \
+    template void sigmoidFast<T>(size_t, const T*, T*); \
+    template void sigmoidTable<T>(size_t, const T*, T*); \
+    template void gemv<T>(size_t, size_t, T, const T*, size_t, const T*, T, T*); \
+    template void gemvTransposed<T>(size_t, size_t, T, const T*, size_t, const T*, T, T*); \
+    template void ger<T>(size_t, size_t, T, const T*, const T*, T*, size_t); \
+    template void gerMomentumUpdate<T>(size_t, size_t, T, const T*, const T*, T, T*, T*, size_t); \
+    template void gemm<T>(bool, bool, size_t, size_t, size_t, T, const T*, size_t, const T*, size_t, T, T*, size_t);
+
+NN_INSTANTIATE_KERNELS(float)
+NN_INSTANTIATE_KERNELS(double)
@@ -0,0 +1,132 @@
+/**
+* Kernels
+*
+* The linear algebra kernels of the nn library. All matrices are row-major, ld is the distance
+* between two rows (the leading dimension). The forward pass, the error propagation and the weight
+* updates of NeuralNet are built on these functions. dot, axpy, momentumUpdate, gemv, sigmoidFast and sigmoidTable
+* use the SIMD variant selected for the CPU at startup (see Simd.h). All kernels are available for
+* float and double, gemvInt8 and gemmInt8 work on 8 bit integers for the quantized inference.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_KERNELS_H
+#define _NEURAL_KERNELS_H
+
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+/**
+* Keeps the scalar arguments out of the template argument deduction, so the type of a kernel is
+* determined by its arrays only and gemv(n, m, 1, A, ...) works for float and double.
+*/
+template<typename T>
+struct Scalar {
+    typedef T Type;
+};
+
+/**
+* Returns the dot product of x and y
+*/
+template<typename T>
+T dot(size_t n, const T* x, const T* y);
+
+/**
+* y = alpha * x + y
+*/
+template<typename T>
+void axpy(size_t n, typename Scalar<T>::Type alpha, const T* x, T* y);
+
+/**
+* x = alpha * x
+*/
+template<typename T>
+void scale(size_t n, typename Scalar<T>::Type alpha, T* x);
+
+/**
+* d = alpha * x + beta * d, w += d in one pass (the momentum update of the weights w with the
+* delta weights d)
+*/
+template<typename T>
+void momentumUpdate(size_t n, typename Scalar<T>::Type alpha, const T* x, typename Scalar<T>::Type beta, T* d, T* w);
+
+/**
+* y = 1 / (1 + exp(-x)) evaluated with the exp of the C library (x and y may be the same buffer)
+*/
+template<typename T>
+void sigmoidExact(size_t n, const T* x, T* y);
+
+/**
+* y = 1 / (1 + exp(-x)) evaluated in SIMD with a polynomial approximation of exp. The maximum
+* absolute error compared to sigmoidExact is 2e-9 for double and 2e-7 for float (x and y may be
+* the same buffer).
+*/
+template<typename T>
+void sigmoidFast(size_t n, const T* x, T* y);
+
+/**
+* y = 1 / (1 + exp(-x)) looked up in a table of 4096 values over [-16, 16] with linear
+* interpolation, x is clamped to that range and NaN is treated like -16. The maximum absolute
+* error compared to sigmoidExact is 8e-7 for double and 1e-6 for float, where the rounding of the
+* table values adds to the interpolation error. The table is built once and shared by all
+* networks of the process.
+*/
+template<typename T>
+void sigmoidTable(size_t n, const T* x, T* y);
+
+/**
+* y = alpha * A * x + beta * y with A being a rows x cols matrix
+*/
+template<typename T>
+void gemv(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* A, size_t lda, const T* x,
+          typename Scalar<T>::Type beta, T* y);
+
+/**
+* y = alpha * A^T * x + beta * y with A being a rows x cols matrix. A is traversed row by row.
+*/
+template<typename T>
+void gemvTransposed(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* A, size_t lda, const T* x,
+                    typename Scalar<T>::Type beta, T* y);
+
+/**
+* A = alpha * x * y^T + A (rank-1 update) with A being a rows x cols matrix
+*/
+template<typename T>
+void ger(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* x, const T* y, T* A, size_t lda);
+
+/**
+* D = alpha * x * y^T + beta * D, W += D with D and W being rows x cols matrices. The rank-1 update
+* of the delta weights and the weights in one pass over both matrices.
+*/
+template<typename T>
+void gerMomentumUpdate(size_t rows, size_t cols, typename Scalar<T>::Type alpha, const T* x, const T* y,
+                       typename Scalar<T>::Type beta, T* D, T* W, size_t ld);
+
+/**
+* C = alpha * op(A) * op(B) + beta * C with op(A) being M x K, op(B) K x N and C M x N.
+* op(X) is X^T if the corresponding trans flag is set. The product is computed on packed,
+* cache-blocked panels with a register-tiled micro-kernel.
+*/
+template<typename T>
+void gemm(bool transA, bool transB, size_t M, size_t N, size_t K, typename Scalar<T>::Type alpha, const T* A,
+          size_t lda, const T* B, size_t ldb, typename Scalar<T>::Type beta, T* C, size_t ldc);
+
+/**
+* y = A * x with A being a rows x cols matrix of signed 8 bit weights and x unsigned 8 bit
+* activations, accumulated in 32 bit integers. With weights in [-127, 127] the sums can not
+* overflow for up to 66000 columns.
+*/
+void gemvInt8(size_t rows, size_t cols, const int8_t* A, size_t lda, const uint8_t* x, int32_t* y);
+
+/**
+* C = B * A^T with A being an M x K matrix of signed 8 bit weights, B an N x K matrix of unsigned
+* 8 bit activations (one vector per row, e.g. the samples of a batch) and C N x M. Every block of
+* four rows of A is applied to all rows of B before the next block is loaded, so it stays in L1.
+*/
+void gemmInt8(size_t M, size_t N, size_t K, const int8_t* A, size_t lda, const uint8_t* B, size_t ldb, int32_t* C,
+              size_t ldc);
+
+#endif
@@ -8,21 +8,49 @@
 */
 
 #include "Layer.h"
+#include "Utils.h"
 
 #include <iostream>
 
 using namespace std;
 
-Layer::Layer(const size_t numNeurons, const size_t numInputsPerNeuron, const bool hasBias)
+template<typename T>
+BasicLayer<T>::BasicLayer(const size_t numNeurons, const size_t numInputsPerNeuron, const bool hasBias)
     : numNeurons(numNeurons),
+      numInputs(hasBias ? numInputsPerNeuron + 1 : numInputsPerNeuron),
+      weights(0),
+      deltaWeights(0),
+      netInputs(0),
+      activations(0),
       hasBias(hasBias)
 {
-    for (size_t n = 0; n < numNeurons; ++n) {
-        this->neurons.push_back(new Neuron(numInputsPerNeuron, hasBias));
-    }
 }
 
-Layer::~Layer() {
-    for(Neuron* neuron : this->neurons)
-        delete neuron;
+template<typename T>
+BasicLayer<T>::~BasicLayer() {
 }
+
+template<typename T>
+void BasicLayer<T>::bind(T* weights, T* deltaWeights, T* netInputs, T* activations) {
+    this->weights = weights;
+    this->deltaWeights = deltaWeights;
+    this->netInputs = netInputs;
+    this->activations = activations;
+}
+
+template<typename T>
+void BasicLayer<T>::randomize() {
+    double XMin = -1;
+    double XMax = 1;
+
+    for (size_t n = 0; n < this->numWeights(); ++n)
+        this->weights[n] = (T) randomDouble(XMin, XMax);
+}
+
+template<typename T>
+BasicNeuron<T> BasicLayer<T>::neuron(size_t index) {
+    return BasicNeuron<T>(this->weightsOf(index), this->deltaWeightsOf(index), this->netInputs + index, this->numInputs);
+}
+
+template class BasicLayer<float>;
+template class BasicLayer<double>;
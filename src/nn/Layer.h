@@ -1,7 +1,9 @@
 /**
 * Layer
 *
-* This class represents a neural network layer with a fixed size.
+* This class represents a neural network layer with a fixed size. The weights of all neurons are
+* stored in one contiguous row-major matrix (one row per neuron, the bias weight is the last column).
+* The layer does not own its buffers, they are placed inside the arena of the neural network.
 *
 * @author Shivan Taher
 * @date 22.03.2009
@@ -17,12 +19,51 @@
 
 using namespace std;
 
-class Layer {
+/**
+* The parts of the layer which do not depend on the scalar type
+*/
+class LayerBase {
 public:
     enum Type { INPUT, HIDDEN, OUTPUT };
+};
+
+template<typename T>
+class BasicLayer : public LayerBase {
+public:
+    BasicLayer(const size_t numNeurons, const size_t numInputsPerNeuron, const bool hasBias = true);
+    ~BasicLayer();
+
+    /**
+    * Sets the buffers of the layer. weights and deltaWeights must hold numWeights() values, netInputs
+    * and activations numNeurons values.
+    */
+    void bind(T* weights, T* deltaWeights, T* netInputs, T* activations);
+
+    /**
+    * Initialises the weights with random values
+    */
+    void randomize();
 
-    Layer(const size_t numNeurons, const size_t numInputsPerNeuron, const bool hasBias = true);
-    ~Layer();
+    /**
+    * Returns a view on the neuron with the given index
+    */
+    BasicNeuron<T> neuron(size_t index);
+
+    /**
+    * Returns the number of weights of the layer
+    */
+    size_t numWeights() const { return this->numNeurons * this->numInputs; }
+
+    /**
+    * Returns a pointer to the weights of the neuron with the given index
+    */
+    T* weightsOf(size_t index) { return this->weights + index * this->numInputs; }
+    const T* weightsOf(size_t index) const { return this->weights + index * this->numInputs; }
+
+    /**
+    * Returns a pointer to the last weight changes of the neuron with the given index
+    */
+    T* deltaWeightsOf(size_t index) { return this->deltaWeights + index * this->numInputs; }
 
     /**
     * Number of neurons in this layer
@@ -30,9 +71,29 @@ public:
     size_t numNeurons;
 
     /**
-    * The neurons of the layer.
+    * Number of weights per neuron including the bias weight (the row stride of the weight matrix)
     */
-    vector<Neuron*> neurons;
+    size_t numInputs;
+
+    /**
+    * The weight matrix (numNeurons x numInputs)
+    */
+    T* weights;
+
+    /**
+    * The last changes of the weights (numNeurons x numInputs)
+    */
+    T* deltaWeights;
+
+    /**
+    * The net inputs of the neurons from the last forward pass
+    */
+    T* netInputs;
+
+    /**
+    * The outputs of the neurons from the last forward pass
+    */
+    T* activations;
 
     /**
     * True if the layer has an additional bias value.
@@ -40,4 +101,6 @@ public:
     bool hasBias;
 };
 
+typedef BasicLayer<double> Layer;
+
 #endif
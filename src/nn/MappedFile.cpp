@@ -0,0 +1,64 @@
+/**
+* MappedFile
+*
+* The implementation of the read-only file mapping.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile()
+    : memory(0),
+      numBytes(0)
+{
+}
+
+MappedFile::~MappedFile() {
+    this->close();
+}
+
+bool MappedFile::open(const string& filename) {
+    this->close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(fd, &status) < 0 || status.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the file descriptor is closed
+    void* memory = mmap(0, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED)
+        return false;
+
+    this->memory = static_cast<char*>(memory);
+    this->numBytes = status.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (this->memory != 0)
+        munmap(this->memory, this->numBytes);
+
+    this->memory = 0;
+    this->numBytes = 0;
+}
+
+void MappedFile::swap(MappedFile& other) {
+    std::swap(this->memory, other.memory);
+    std::swap(this->numBytes, other.numBytes);
+}
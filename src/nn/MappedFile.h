@@ -0,0 +1,57 @@
+/**
+* MappedFile
+*
+* A file mapped read-only into memory. The pages are shared with all other processes which map the
+* same file, so a model served by several processes is held in memory only once.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_MAPPED_FILE_H
+#define _NEURAL_MAPPED_FILE_H
+
+#include <iostream>
+
+using namespace std;
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /**
+    * Maps the whole file, a previously mapped file is released. Returns false if the file can not
+    * be opened or is empty.
+    */
+    bool open(const string& filename);
+
+    /**
+    * Releases the mapping
+    */
+    void close();
+
+    /**
+    * Exchanges the mappings of two files
+    */
+    void swap(MappedFile& other);
+
+    /**
+    * Returns the beginning of the mapped file (page aligned)
+    */
+    const char* data() const { return this->memory; }
+
+    /**
+    * Returns the size of the file in bytes
+    */
+    size_t size() const { return this->numBytes; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    char* memory;
+    size_t numBytes;
+};
+
+#endif
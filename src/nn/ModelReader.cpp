@@ -0,0 +1,441 @@
+/**
+* ModelReader
+*
+* The implementation of the streaming model reader.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "ModelReader.h"
+
+#include <limits>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The file is read in chunks of this size
+static const size_t CHUNK_SIZE = 1 << 20;
+
+// Number of bytes which are always available in front of a token (longer numbers are invalid)
+static const size_t MAX_TOKEN_SIZE = 64;
+
+/**
+* Returns true for the characters of a JSON number
+*/
+static inline bool isNumberCharacter(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '.' || c == 'e' || c == 'E' || c == '+';
+}
+
+/**
+* A pull parser for JSON which reads the file in chunks
+*/
+class JsonStream {
+public:
+    JsonStream(FILE* file)
+        : file(file),
+          buffer(CHUNK_SIZE + MAX_TOKEN_SIZE + 1),
+          position(0),
+          end(0)
+    {
+    }
+
+    /**
+    * Returns the next character after white space without consuming it, 0 at the end of the file
+    */
+    char peek() {
+        while (true) {
+            this->fill(MAX_TOKEN_SIZE);
+
+            if (this->position == this->end)
+                return 0;
+
+            char c = this->buffer[this->position];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                return c;
+
+            this->position++;
+        }
+    }
+
+    /**
+    * Consumes the character c if it is next
+    */
+    bool accept(char c) {
+        if (this->peek() != c)
+            return false;
+
+        this->position++;
+        return true;
+    }
+
+    bool readString(string& value) {
+        if (!this->accept('"'))
+            return false;
+
+        value.clear();
+
+        while (true) {
+            this->fill(2);
+
+            if (this->position == this->end)
+                return false;
+
+            char c = this->buffer[this->position++];
+
+            if (c == '"')
+                return true;
+
+            // Escaped characters are taken literally, keys and types of a model are plain ASCII
+            if (c == '\\') {
+                if (this->position == this->end)
+                    return false;
+
+                c = this->buffer[this->position++];
+            }
+
+            value += c;
+        }
+    }
+
+    bool readBool(bool& value) {
+        char c = this->peek();
+
+        if (c == 't' && this->matches("true")) {
+            value = true;
+            return true;
+        }
+
+        if (c == 'f' && this->matches("false")) {
+            value = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+    * Reads a number. NaN is written as null by the JSON writers, infinite values as 1e+9999 which
+    * strtod converts to infinity.
+    */
+    bool readNumber(double& value) {
+        if (this->peek() == 'n') {
+            value = numeric_limits<double>::quiet_NaN();
+            return this->matches("null");
+        }
+
+        char* tokenEnd;
+        value = strtod(&this->buffer[this->position], &tokenEnd);
+        return this->consumeNumber(tokenEnd);
+    }
+
+    bool readNumber(float& value) {
+        if (this->peek() == 'n') {
+            value = numeric_limits<float>::quiet_NaN();
+            return this->matches("null");
+        }
+
+        char* tokenEnd;
+        value = strtof(&this->buffer[this->position], &tokenEnd);
+        return this->consumeNumber(tokenEnd);
+    }
+
+    /**
+    * Skips a number without converting it
+    */
+    bool skipNumber() {
+        if (this->peek() == 'n')
+            return this->matches("null");
+
+        size_t start = this->position;
+        while (this->position < this->end && isNumberCharacter(this->buffer[this->position]))
+            this->position++;
+
+        return this->position > start;
+    }
+
+    /**
+    * Skips any value including nested objects and arrays
+    */
+    bool skipValue() {
+        char c = this->peek();
+
+        if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            this->position++;
+
+            if (this->accept(close))
+                return true;
+
+            do {
+                if (c == '{') {
+                    string key;
+                    if (!this->readString(key) || !this->accept(':'))
+                        return false;
+                }
+
+                if (!this->skipValue())
+                    return false;
+            } while (this->accept(','));
+
+            return this->accept(close);
+        }
+
+        if (c == '"') {
+            string value;
+            return this->readString(value);
+        }
+
+        if (c == 't' || c == 'f') {
+            bool value;
+            return this->readBool(value);
+        }
+
+        if (c == 'n')
+            return this->matches("null");
+
+        return this->skipNumber();
+    }
+
+private:
+    /**
+    * Makes sure that at least n bytes are buffered unless the file ends earlier. The buffer is
+    * always terminated with 0, so strtod stops at the end of the data.
+    */
+    void fill(size_t n) {
+        if (this->end - this->position >= n || this->file == 0)
+            return;
+
+        size_t remaining = this->end - this->position;
+        memmove(&this->buffer[0], &this->buffer[this->position], remaining);
+        this->position = 0;
+        this->end = remaining;
+
+        size_t numBytes = fread(&this->buffer[this->end], 1, CHUNK_SIZE, this->file);
+        this->end += numBytes;
+        this->buffer[this->end] = 0;
+
+        if (numBytes == 0)
+            this->file = 0;
+    }
+
+    bool matches(const char* literal) {
+        size_t length = strlen(literal);
+
+        if (this->end - this->position < length || strncmp(&this->buffer[this->position], literal, length) != 0)
+            return false;
+
+        this->position += length;
+        return true;
+    }
+
+    bool consumeNumber(char* tokenEnd) {
+        size_t length = tokenEnd - &this->buffer[this->position];
+        this->position += length;
+        return length > 0;
+    }
+
+    FILE* file;
+    vector<char> buffer;
+    size_t position;
+    size_t end;
+};
+
+/**
+* Reads the neurons of a layer. Without destination only the neurons and their weights are counted,
+* otherwise the weights are written to the destination with a row stride of numInputs.
+*/
+template<typename T>
+static bool readNeurons(JsonStream& json, T* weights, size_t& numNeurons, size_t& numInputs) {
+    size_t numRows = numNeurons;
+    numNeurons = 0;
+
+    if (!json.accept('['))
+        return false;
+    if (json.accept(']'))
+        return true;
+
+    do {
+        if (!json.accept('{'))
+            return false;
+
+        if (!json.accept('}')) {
+            do {
+                string key;
+                if (!json.readString(key) || !json.accept(':'))
+                    return false;
+
+                if (key != "weights") {
+                    if (!json.skipValue())
+                        return false;
+                    continue;
+                }
+
+                if (!json.accept('['))
+                    return false;
+
+                size_t numWeights = 0;
+
+                if (!json.accept(']')) {
+                    do {
+                        bool valid;
+
+                        if (weights == 0) {
+                            valid = json.skipNumber();
+                        } else {
+                            // The topology of the first pass limits the destination
+                            if (numNeurons >= numRows || numWeights >= numInputs)
+                                return false;
+
+                            valid = json.readNumber(weights[numNeurons * numInputs + numWeights]);
+                        }
+
+                        if (!valid)
+                            return false;
+
+                        numWeights++;
+                    } while (json.accept(','));
+
+                    if (!json.accept(']'))
+                        return false;
+                }
+
+                // All neurons of a layer have the same number of weights
+                if (weights == 0 && numNeurons == 0)
+                    numInputs = numWeights;
+                else if (numWeights != numInputs)
+                    return false;
+            } while (json.accept(','));
+
+            if (!json.accept('}'))
+                return false;
+        }
+
+        numNeurons++;
+    } while (json.accept(','));
+
+    return json.accept(']');
+}
+
+/**
+* Reads a model. Without layerWeights the topology is read, otherwise the weights are written to
+* the matrices of the layers of the given topology.
+*/
+template<typename T>
+static bool readModel(const string& filename, ModelTopology& topology, const vector<T*>* layerWeights) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == 0)
+        return false;
+
+    JsonStream json(file);
+    vector<size_t> layerInputs;
+    bool valid = json.accept('{');
+
+    if (valid && !json.accept('}')) {
+        do {
+            string key;
+            valid = json.readString(key) && json.accept(':');
+
+            if (valid && key == "layers") {
+                valid = json.accept('[');
+                size_t index = 0;
+
+                if (valid && !json.accept(']')) {
+                    do {
+                        bool hasBias = false;
+                        size_t numNeurons = 0, numInputs = 0;
+                        T* weights = 0;
+
+                        if (layerWeights != 0) {
+                            valid = index < topology.layerSizes.size();
+                            if (!valid)
+                                break;
+
+                            numNeurons = topology.layerSizes[index];
+                            numInputs = index == 0 ? 0 : topology.layerSizes[index - 1] + (topology.layerBiases[index] ? 1 : 0);
+                            weights = index == 0 ? 0 : (*layerWeights)[index];
+                        }
+
+                        valid = json.accept('{');
+
+                        if (valid && !json.accept('}')) {
+                            do {
+                                string layerKey;
+                                valid = json.readString(layerKey) && json.accept(':');
+
+                                if (valid && layerKey == "hasBias")
+                                    valid = json.readBool(hasBias);
+                                else if (valid && layerKey == "neurons")
+                                    valid = readNeurons(json, weights, numNeurons, numInputs);
+                                else if (valid)
+                                    valid = json.skipValue();
+                            } while (valid && json.accept(','));
+
+                            valid = valid && json.accept('}');
+                        }
+
+                        if (layerWeights != 0 && numNeurons != topology.layerSizes[index])
+                            valid = false;
+
+                        if (layerWeights == 0) {
+                            topology.layerSizes.push_back(numNeurons);
+                            topology.layerBiases.push_back(hasBias);
+                            layerInputs.push_back(numInputs);
+                        }
+
+                        index++;
+                    } while (valid && json.accept(','));
+
+                    valid = valid && json.accept(']');
+                }
+            } else if (valid && layerWeights == 0 && key == "scalarType") {
+                valid = json.readString(topology.scalarType);
+            } else if (valid && layerWeights == 0 && key == "useBias") {
+                valid = json.readBool(topology.useBias);
+            } else if (valid && layerWeights == 0 && key == "biasValue") {
+                valid = json.readNumber(topology.biasValue);
+            } else if (valid) {
+                valid = json.skipValue();
+            }
+        } while (valid && json.accept(','));
+
+        valid = valid && json.accept('}');
+    }
+
+    fclose(file);
+
+    if (!valid || layerWeights != 0)
+        return valid;
+
+    // The number of weights of every layer must match the size of its predecessor
+    if (topology.layerSizes.size() < 2 || layerInputs[0] != 0)
+        return false;
+
+    for (size_t i = 1; i < topology.layerSizes.size(); ++i) {
+        if (topology.layerSizes[i] == 0 || layerInputs[i] != topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0))
+            return false;
+    }
+
+    return true;
+}
+
+bool ModelReader::open(const string& filename) {
+    this->filename = filename;
+    this->topology = ModelTopology();
+    return readModel<double>(filename, this->topology, 0);
+}
+
+const ModelTopology& ModelReader::getTopology() const {
+    return this->topology;
+}
+
+template<typename T>
+bool ModelReader::readWeights(const vector<T*>& layerWeights) {
+    if (layerWeights.size() != this->topology.layerSizes.size())
+        return false;
+
+    return readModel<T>(this->filename, this->topology, &layerWeights);
+}
+
+template bool ModelReader::readWeights<float>(const vector<float*>&);
+template bool ModelReader::readWeights<double>(const vector<double*>&);
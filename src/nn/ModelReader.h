@@ -0,0 +1,68 @@
+/**
+* ModelReader
+*
+* A streaming reader for the JSON models written by NeuralNet::save(). The file is read in chunks
+* and never held as a document tree: the first pass only counts the layers, neurons and weights,
+* the second pass converts the weights directly into the memory of the network. Networks use it
+* to allocate their storage for the topology and then let the reader fill it.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_MODEL_READER_H
+#define _NEURAL_MODEL_READER_H
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+* The topology and the settings of a saved network
+*/
+struct ModelTopology {
+    ModelTopology() : useBias(true), biasValue(1) {}
+
+    string scalarType;
+    bool useBias;
+    double biasValue;
+
+    /**
+    * The number of neurons of each layer (the first one is the input layer)
+    */
+    vector<size_t> layerSizes;
+
+    /**
+    * True for each layer with a bias weight
+    */
+    vector<bool> layerBiases;
+};
+
+class ModelReader {
+public:
+    /**
+    * Opens a model file and reads its topology. Returns false if the file can not be read or is
+    * not a valid model.
+    */
+    bool open(const string& filename);
+
+    /**
+    * Returns the topology read by open()
+    */
+    const ModelTopology& getTopology() const;
+
+    /**
+    * Reads the weights of every layer into the given row-major matrices (numNeurons x numInputs
+    * including the bias column). layerWeights holds one pointer per layer, the one of the input
+    * layer is not used.
+    */
+    template<typename T>
+    bool readWeights(const vector<T*>& layerWeights);
+
+private:
+    string filename;
+    ModelTopology topology;
+};
+
+#endif
@@ -9,287 +9,935 @@
 */
 
 #include "NeuralNet.h"
+#include "BinaryModel.h"
+#include "Checkpointer.h"
+#include "Kernels.h"
+#include "MappedFile.h"
 #include "Utils.h"
 
-#include <json/json.h>
-
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <math.h>
+#include <stdio.h>
+
+/**
+* Writes a number with enough digits to read back the same value (17 for double, 9 for float).
+* Infinite values and NaN are written like the JSON library does.
+*/
+template<typename T>
+static void writeNumber(ostream& out, T value) {
+    char buffer[32];
+    int length;
+
+    if (isfinite(value))
+        length = snprintf(buffer, sizeof(buffer), "%.*g", numeric_limits<T>::max_digits10, (double) value);
+    else if (value != value)
+        length = snprintf(buffer, sizeof(buffer), "null");
+    else
+        length = snprintf(buffer, sizeof(buffer), value < 0 ? "-1e+9999" : "1e+9999");
+
+    out.write(buffer, length);
+}
 
-NeuralNet::NeuralNet(const string& name)
+template<typename T>
+BasicNeuralNet<T>::BasicNeuralNet(const string& name)
     : numHiddenLayers(0),
       momentum(0.9),
       learningRate(1),
       biasValue(1),
       useBias(true),
+      sigmoidMode(EXACT),
+      pool(0),
+      checkpointer(0),
+      checkpointInterval(0),
+      numUpdates(0),
+      lastCheckpoint(0),
       name(name)
 {
 }
 
-NeuralNet::~NeuralNet() {
-    for(Layer* layer : this->layers)
-        delete layer;
+template<typename T>
+BasicNeuralNet<T>::~BasicNeuralNet() {
 }
 
-void NeuralNet::add(Layer::Type layerType, size_t numNeurons) {
-    if (layerType == Layer::INPUT) {
+template<typename T>
+void BasicNeuralNet<T>::add(LayerBase::Type layerType, size_t numNeurons) {
+    if (layerType == LayerBase::INPUT) {
         // Create the input layer
-        this->layers.push_back(new Layer(numNeurons, 0, false));
-    } else if (layerType == Layer::HIDDEN) {
+        this->layers.push_back(BasicLayer<T>(numNeurons, 0, false));
+    } else if (layerType == LayerBase::HIDDEN) {
         // Create the hidden layers
         this->numHiddenLayers++;
-        Layer* lastLayer = this->layers[this->layers.size() - 1];
-        this->layers.push_back(new Layer(numNeurons, lastLayer->numNeurons, this->useBias));
-    } else if (layerType == Layer::OUTPUT) {
-        // Create the output layer
-        Layer* lastLayer = this->layers[this->layers.size() - 1];
-        this->layers.push_back(new Layer(numNeurons, lastLayer->numNeurons, this->useBias));
+        const BasicLayer<T>& lastLayer = this->layers.back();
+        this->layers.push_back(BasicLayer<T>(numNeurons, lastLayer.numNeurons, this->useBias));
+    } else if (layerType == LayerBase::OUTPUT) {
+        // Create the output layer and allocate the network since the topology is complete now
+        const BasicLayer<T>& lastLayer = this->layers.back();
+        this->layers.push_back(BasicLayer<T>(numNeurons, lastLayer.numNeurons, this->useBias));
+        this->allocate();
+
+        for (BasicLayer<T>& layer : this->layers)
+            layer.randomize();
+    }
+}
+
+template<typename T>
+void BasicNeuralNet<T>::allocate() {
+    // Layout: all weights, all delta weights, all net inputs, all activations.
+    // Every block starts at a cache line boundary.
+    size_t numBytes = 0;
+    for (const BasicLayer<T>& layer : this->layers) {
+        numBytes += 2 * Arena::align(layer.numWeights() * sizeof(T));
+        numBytes += 2 * Arena::align(layer.numNeurons * sizeof(T));
+    }
+
+    this->arena.allocate(numBytes);
+
+    char* weights = this->arena.data();
+    char* deltaWeights = weights;
+    for (const BasicLayer<T>& layer : this->layers)
+        deltaWeights += Arena::align(layer.numWeights() * sizeof(T));
+
+    char* netInputs = deltaWeights + (deltaWeights - weights);
+    char* activations = netInputs;
+    for (const BasicLayer<T>& layer : this->layers)
+        activations += Arena::align(layer.numNeurons * sizeof(T));
+
+    size_t maxNeurons = 0;
+    for (const BasicLayer<T>& layer : this->layers)
+        maxNeurons = max(maxNeurons, layer.numNeurons);
+
+    this->outputs.reserve(this->layers.back().numNeurons);
+    for (vector<T>& buffer : this->deltaBuffers)
+        buffer.assign(maxNeurons, 0);
+
+    for (BasicLayer<T>& layer : this->layers) {
+        layer.bind(reinterpret_cast<T*>(weights), reinterpret_cast<T*>(deltaWeights),
+                   reinterpret_cast<T*>(netInputs), reinterpret_cast<T*>(activations));
+
+        weights += Arena::align(layer.numWeights() * sizeof(T));
+        deltaWeights += Arena::align(layer.numWeights() * sizeof(T));
+        netInputs += Arena::align(layer.numNeurons * sizeof(T));
+        activations += Arena::align(layer.numNeurons * sizeof(T));
     }
 }
 
-double NeuralNet::sigmoid(double x) {
+template<typename T>
+void BasicNeuralNet<T>::setThreadPool(ThreadPool* pool) {
+    this->pool = pool;
+}
+
+template<typename T>
+void BasicNeuralNet<T>::setCheckpointer(BasicCheckpointer<T>* checkpointer, size_t interval) {
+    this->checkpointer = interval > 0 ? checkpointer : 0;
+    this->checkpointInterval = interval;
+    this->numUpdates = 0;
+    this->lastCheckpoint = 0;
+}
+
+template<typename T>
+void BasicNeuralNet<T>::checkpointRelaxed() {
+    if (this->checkpointer == 0)
+        return;
+
+    // The other threads count their updates at the same time
+    size_t updates = __atomic_load_n(&this->numUpdates, __ATOMIC_RELAXED);
+
+    if (updates / this->checkpointInterval > this->lastCheckpoint / this->checkpointInterval) {
+        this->lastCheckpoint = updates;
+        this->checkpointer->snapshotRelaxed();
+    }
+}
+
+template<typename T>
+void BasicNeuralNet<T>::countUpdate() {
+    if (this->checkpointer != 0 && ++this->numUpdates % this->checkpointInterval == 0)
+        this->checkpointer->snapshot();
+}
+
+template<typename T>
+size_t BasicNeuralNet<T>::getNumLayers() const {
+    return this->layers.size();
+}
+
+template<typename T>
+const BasicLayer<T>& BasicNeuralNet<T>::getLayer(size_t index) const {
+    return this->layers[index];
+}
+
+template<typename T>
+size_t BasicNeuralNet<T>::getNumInputs() const {
+    return this->layers.front().numNeurons;
+}
+
+template<typename T>
+size_t BasicNeuralNet<T>::getNumOutputs() const {
+    return this->layers.back().numNeurons;
+}
+
+template<typename T>
+const Arena& BasicNeuralNet<T>::getArena() const {
+    return this->arena;
+}
+
+template<typename T>
+size_t BasicNeuralNet<T>::getNumParameters() const {
+    size_t numParameters = 0;
+    for (const BasicLayer<T>& layer : this->layers)
+        numParameters += layer.numWeights();
+    return numParameters;
+}
+
+template<typename T>
+T BasicNeuralNet<T>::sigmoid(T x) {
     //double response = 1;
     //return 1/(1+exp(-x/response));
     return 1 / (1 + exp(-x));
 }
 
-double NeuralNet::sigmoidDerivation(double x) {
-    double gx = this->sigmoid(x);
+template<typename T>
+T BasicNeuralNet<T>::sigmoidDerivation(T x) {
+    T gx = this->sigmoid(x);
     return gx * (1 - gx);
 }
 
-const vector<double>& NeuralNet::calculateOutputs(vector<double> inputs) {
-    // Results
-    this->outputs.clear();
+template<typename T>
+void BasicNeuralNet<T>::activate(size_t n, const T* netInputs, T* activations, SigmoidMode mode) const {
+    if (mode == FAST)
+        sigmoidFast(n, netInputs, activations);
+    else if (mode == TABLE)
+        sigmoidTable(n, netInputs, activations);
+    else
+        sigmoidExact(n, netInputs, activations);
+}
 
-    // Check the size of the inputs
-    if (inputs.size() != this->layers[0]->numNeurons)
-        return outputs;
+template<typename T>
+typename BasicNeuralNet<T>::SigmoidMode BasicNeuralNet<T>::getTrainingSigmoidMode() const {
+    // The lookup table is only accurate enough for inference
+    return this->sigmoidMode == TABLE ? EXACT : this->sigmoidMode;
+}
 
-    // For each layer
-    for (size_t i = 0; i < this->layers.size(); ++i) {
-        if (i > 0) // The input is the output of the last layer
-            inputs = this->outputs;
+template<typename T>
+const vector<T>& BasicNeuralNet<T>::calculateOutputs(const vector<T>& inputs) {
+    const T* results = this->calculateOutputs(inputs.data(), inputs.size());
 
+    // The capacity of the outputs is reserved in allocate(), so assign() does not allocate
+    if (results == 0)
         this->outputs.clear();
-        
-        Layer* li = this->layers[i];
+    else
+        this->outputs.assign(results, results + this->layers.back().numNeurons);
+
+    return this->outputs;
+}
+
+template<typename T>
+const T* BasicNeuralNet<T>::calculateOutputs(const T* inputs, size_t numInputs) {
+    // Check the size of the inputs
+    if (numInputs != this->layers[0].numNeurons)
+        return 0;
 
-        // Calculate the outputs = sigmoid(sum of (inputs * weights))
+    return this->forward(inputs, this->sigmoidMode);
+}
 
-        for (size_t j = 0; j < li->numNeurons; ++j) {
-            Neuron* nj = li->neurons[j];
+template<typename T>
+const T* BasicNeuralNet<T>::forward(const T* inputs, SigmoidMode mode) {
+    // The input layer only applies the activation function
+    BasicLayer<T>* inputLayer = &this->layers[0];
+    copy(inputs, inputs + inputLayer->numNeurons, inputLayer->netInputs);
+    this->activate(inputLayer->numNeurons, inputLayer->netInputs, inputLayer->activations, mode);
 
-            double netinput = 0;
+    // For each following layer
+    for (size_t i = 1; i < this->layers.size(); ++i) {
+        const BasicLayer<T>& li = this->layers[i];
 
-            size_t numInputs = nj->numInputs;
+        if (this->pool == 0 || li.numWeights() < PARALLEL_THRESHOLD) {
+            this->forwardNeurons(i, 0, li.numNeurons, mode);
+            continue;
+        }
 
-            // For each weight
-            // Calculate the net input (sum of inputs * weights)
+        // Split wide layers into ranges of neurons, a few per thread so they can be balanced by stealing
+        size_t grainSize = max(li.numNeurons / (4 * this->pool->getNumThreads()), size_t(16));
 
-            // Ignore the input layer
-            if (i > 0) {
-                for (size_t k = 0; k < inputs.size(); ++k)
-                    netinput += nj->weights[k] * inputs[k];
-            } else {
-                netinput = inputs[j];
-            }
+        this->pool->parallelFor(0, li.numNeurons, grainSize, [this, i, mode](size_t first, size_t last) {
+            this->forwardNeurons(i, first, last, mode);
+        });
+    }
 
-            // Add the bias value if enabled
-            if (this->useBias && li->hasBias) {
-                netinput += nj->weights[numInputs - 1] * this->biasValue;
-            }
+    return this->layers.back().activations;
+}
+
+template<typename T>
+void BasicNeuralNet<T>::forwardNeurons(size_t i, size_t first, size_t last, SigmoidMode mode) {
+    BasicLayer<T>* li = &this->layers[i];
 
-            nj->netInput = netinput;
-            this->outputs.push_back(sigmoid(netinput));
+    // The input is the output of the last layer
+    const BasicLayer<T>* prev = &this->layers[i - 1];
+
+    // Calculate the net inputs (weights * inputs) of the neurons
+    gemv(last - first, prev->numNeurons, 1, li->weightsOf(first), li->numInputs, prev->activations, 0,
+         li->netInputs + first);
+
+    // Add the bias value if enabled
+    if (this->useBias && li->hasBias) {
+        for (size_t j = first; j < last; ++j)
+            li->netInputs[j] += li->weightsOf(j)[li->numInputs - 1] * this->biasValue;
+    }
+
+    // Calculate the outputs = sigmoid(net input)
+    this->activate(last - first, li->netInputs + first, li->activations + first, mode);
+}
+
+template<typename T>
+const vector<T>& BasicNeuralNet<T>::calculateOutputsBatch(const vector<T>& inputs, size_t batchSize) {
+    // Check the size of the inputs
+    if (inputs.size() != batchSize * this->layers[0].numNeurons) {
+        this->batchOutputs.clear();
+        return this->batchOutputs;
+    }
+
+    const T* results = this->calculateOutputsBatch(inputs.data(), batchSize);
+    this->batchOutputs.assign(results, results + batchSize * this->layers.back().numNeurons);
+
+    return this->batchOutputs;
+}
+
+template<typename T>
+const T* BasicNeuralNet<T>::calculateOutputsBatch(const T* inputs, size_t batchSize) {
+    // The layers write alternately into the two batch buffers
+    size_t maxNeurons = 0;
+    for (const BasicLayer<T>& layer : this->layers)
+        maxNeurons = max(maxNeurons, layer.numNeurons);
+
+    for (vector<T>& buffer : this->batchBuffers) {
+        if (buffer.size() < batchSize * maxNeurons)
+            buffer.resize(batchSize * maxNeurons);
+    }
+
+    // The input layer only applies the activation function
+    const BasicLayer<T>& inputLayer = this->layers[0];
+    T* outputs = this->batchBuffers[0].data();
+
+    this->activate(batchSize * inputLayer.numNeurons, inputs, outputs, this->sigmoidMode);
+
+    for (size_t i = 1; i < this->layers.size(); ++i) {
+        const BasicLayer<T>& li = this->layers[i];
+        const T* layerInputs = outputs;
+        size_t numInputs = this->layers[i - 1].numNeurons;
+        outputs = this->batchBuffers[i % 2].data();
+
+        // Net inputs (batchSize x numNeurons) = inputs (batchSize x numInputs) * weights^T
+        gemm(false, true, batchSize, li.numNeurons, numInputs, 1, layerInputs, numInputs,
+             li.weights, li.numInputs, 0, outputs, li.numNeurons);
+
+        // Add the bias value if enabled
+        if (this->useBias && li.hasBias) {
+            for (size_t b = 0; b < batchSize; ++b) {
+                T* row = outputs + b * li.numNeurons;
+
+                for (size_t j = 0; j < li.numNeurons; ++j)
+                    row[j] += li.weightsOf(j)[li.numInputs - 1] * this->biasValue;
+            }
         }
+
+        // Apply the activation function to the whole batch
+        this->activate(batchSize * li.numNeurons, outputs, outputs, this->sigmoidMode);
     }
 
-    return this->outputs;
+    return outputs;
 }
 
-const vector<double>& NeuralNet::getOutputs() const {
+template<typename T>
+const vector<T>& BasicNeuralNet<T>::getOutputs() const {
     return this->outputs;
 }
 
-double NeuralNet::backpropagation(const vector<double>& inputs, const vector<double>& expectedOutputs) {
-    // Error values
-    vector<double> delta_j, delta_i;
-    double standardError = 0;
+template<typename T>
+T BasicNeuralNet<T>::backpropagation(const vector<T>& inputs, const vector<T>& expectedOutputs) {
+    // Error values of the current layer and of its successor
+    T* delta_i = this->deltaBuffers[0].data();
+    T* delta_j = this->deltaBuffers[1].data();
+    T standardError = 0;
 
     // Calculate the activity of the network first
-    this->calculateOutputs(inputs);
+    const T* results = this->forward(inputs.data(), this->getTrainingSigmoidMode());
+    this->outputs.assign(results, results + this->layers.back().numNeurons);
 
     //
     // Calculate and correct the errors of the output unit
     //
 
-    Layer* outputLayer = this->layers[this->layers.size() - 1];
+    BasicLayer<T>* outputLayer = &this->layers.back();
 
     for (size_t i = 0; i < outputLayer->numNeurons; i++) {
-        Neuron* ni = outputLayer->neurons[i];
-
         // Err = y - aj = y - g(net_j)
-        double err = expectedOutputs[i] - this->outputs[i];
+        T a_i = outputLayer->activations[i];
+        T err = expectedOutputs[i] - a_i;
         standardError += err;
 
-        // netinput of the neuron i
-        double net_i = ni->netInput;
+        // g'(net_i) = g(net_i) * (1 - g(net_i)) with the activation cached by the forward pass
+        delta_i[i] = err * a_i * (1 - a_i);
+    }
+
+    standardError /= outputLayer->numNeurons;
+    standardError = (standardError * standardError) / 2; // E = 1/2 Err^2
 
-        double di = err * this->sigmoidDerivation(net_i);
-        delta_i.push_back(di);
+    //
+    // Propagate the errors to the predecessor layer and correct the weights, from the output layer
+    // down to the first hidden layer
+    //
 
-        // Correct the weights between the output layer and the hidden layer
+    for (size_t L = this->numHiddenLayers + 1; L > 0; L--) {
+        BasicLayer<T>* layer = &this->layers[L];
+        BasicLayer<T>* prevLayer = &this->layers[L - 1];
 
-        size_t numInputsI = ni->numInputs;
-        for (size_t j = 0; j < numInputsI; j++) {
-            double net_j;
+        // The errors of the hidden predecessor are calculated before the weights change:
+        // err_j = sum_i w_ij * delta_i, a contiguous transposed gemv over the weight rows
+        if (L > 1) {
+            gemvTransposed(layer->numNeurons, prevLayer->numNeurons, 1, layer->weights, layer->numInputs, delta_i, 0,
+                           delta_j);
 
-            // Does the layer have a bias and is j the bias neuron?
-            if (outputLayer->hasBias && j == numInputsI - 1) {
-                net_j = this->biasValue;
-            } else {
-                net_j = this->layers[this->numHiddenLayers]->neurons[j]->netInput;
+            for (size_t j = 0; j < prevLayer->numNeurons; j++) {
+                T a_j = prevLayer->activations[j];
+                delta_j[j] *= a_j * (1 - a_j);
             }
+        }
+
+        // Correct the weights between the layer and its predecessor
+        this->updateWeights(layer, prevLayer, delta_i);
+
+        swap(delta_i, delta_j);
+    }
+
+    this->countUpdate();
+
+    return standardError;
+}
 
-            double delta_w = this->learningRate * this->sigmoid(net_j) * di + this->momentum * ni->deltaWeights[j];
+template<typename T>
+void BasicNeuralNet<T>::updateWeights(BasicLayer<T>* layer, const BasicLayer<T>* prevLayer, const T* deltas) {
+    // delta_w = learningRate * delta * a + momentum * delta_w(t - 1), w += delta_w in one pass
+    gerMomentumUpdate(layer->numNeurons, prevLayer->numNeurons, this->learningRate, deltas, prevLayer->activations,
+                      this->momentum, layer->deltaWeights, layer->weights, layer->numInputs);
 
-            ni->deltaWeights[j] = delta_w;
-            ni->weights[j] += delta_w;
+    // The input of the bias weight is the bias value, a disabled bias is not trained (like in
+    // computeGradients)
+    if (this->useBias && layer->hasBias) {
+        for (size_t i = 0; i < layer->numNeurons; i++) {
+            T& deltaWeight = layer->deltaWeightsOf(i)[layer->numInputs - 1];
+            deltaWeight = this->learningRate * this->biasValue * deltas[i] + this->momentum * deltaWeight;
+            layer->weightsOf(i)[layer->numInputs - 1] += deltaWeight;
         }
     }
+}
 
-    standardError /= outputLayer->numNeurons;
-    standardError = (standardError * standardError) / 2; // E = 1/2 Err^2
+template<typename T>
+T BasicNeuralNet<T>::trainBatch(const vector<T>& inputs, const vector<T>& expectedOutputs) {
+    size_t numInputs = this->layers[0].numNeurons;
+    size_t numOutputs = this->layers.back().numNeurons;
+    size_t batchSize = inputs.size() / numInputs;
+
+    // Check the size of the inputs and the expected outputs
+    if (batchSize == 0 || inputs.size() != batchSize * numInputs || expectedOutputs.size() != batchSize * numOutputs)
+        return 0;
+
+    return this->trainBatch(inputs.data(), expectedOutputs.data(), batchSize);
+}
+
+template<typename T>
+T BasicNeuralNet<T>::trainBatch(const T* inputs, const T* expectedOutputs, size_t batchSize) {
+    if (batchSize == 0)
+        return 0;
+
+    T standardError = this->computeGradients(inputs, expectedOutputs, batchSize, this->workspace);
+    this->applyGradients(this->workspace, T(1) / batchSize);
+
+    return standardError / batchSize;
+}
+
+template<typename T>
+T BasicNeuralNet<T>::train(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t batchSize,
+                           size_t epochs) {
+    size_t numInputs = this->layers[0].numNeurons;
+    size_t numOutputs = this->layers.back().numNeurons;
+    size_t numSamples = inputs.size() / numInputs;
+
+    // Check the size of the dataset
+    if (inputs.size() != numSamples * numInputs || expectedOutputs.size() != numSamples * numOutputs)
+        return 0;
+
+    return this->train(inputs.data(), expectedOutputs.data(), numSamples, batchSize, epochs);
+}
+
+template<typename T>
+T BasicNeuralNet<T>::train(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t batchSize,
+                           size_t epochs) {
+    size_t numInputs = this->layers[0].numNeurons;
+    size_t numOutputs = this->layers.back().numNeurons;
+
+    if (batchSize == 0 || numSamples == 0)
+        return 0;
+
+    T standardError = 0;
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        standardError = 0;
+
+        for (size_t first = 0; first < numSamples; first += batchSize) {
+            size_t n = min(batchSize, numSamples - first);
+            standardError += n * this->trainBatch(&inputs[first * numInputs], &expectedOutputs[first * numOutputs], n);
+        }
+
+        standardError /= numSamples;
+    }
+
+    return standardError;
+}
+
+template<typename T>
+T BasicNeuralNet<T>::train(const BasicDataset<T>& dataset, size_t batchSize, size_t epochs) {
+    if (dataset.getNumInputs() != this->layers[0].numNeurons || dataset.getNumOutputs() != this->layers.back().numNeurons)
+        return 0;
+
+    return this->train(dataset.getInputs(), dataset.getOutputs(), dataset.getNumSamples(), batchSize, epochs);
+}
+
+template<typename T>
+T BasicNeuralNet<T>::train(BasicBatchPipeline<T>& pipeline, size_t epochs) {
+    const BasicDataset<T>& dataset = pipeline.getDataset();
+
+    if (dataset.getNumSamples() == 0 || dataset.getNumInputs() != this->layers[0].numNeurons || dataset.getNumOutputs() != this->layers.back().numNeurons)
+        return 0;
+
+    T standardError = 0;
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        standardError = 0;
+
+        // The pipeline gathers the next batch while this one is trained
+        for (size_t n = pipeline.next(); n > 0; n = pipeline.next())
+            standardError += n * this->trainBatch(pipeline.getInputs(), pipeline.getOutputs(), n);
+
+        standardError /= dataset.getNumSamples();
+    }
+
+    return standardError;
+}
+
+template<typename T>
+void BasicNeuralNet<T>::prepareWorkspace(BasicWorkspace<T>& workspace, size_t batchSize) const {
+    size_t numLayers = this->layers.size();
+
+    workspace.batchSize = max(batchSize, workspace.batchSize);
+    workspace.activations.resize(numLayers);
+    workspace.deltas.resize(numLayers);
+    workspace.gradients.resize(numLayers);
+
+    // Every buffer is checked against its layer, the workspace may come from another topology
+    for (size_t i = 0; i < numLayers; ++i) {
+        const BasicLayer<T>& layer = this->layers[i];
+        size_t numValues = workspace.batchSize * layer.numNeurons;
+
+        if (workspace.activations[i].size() < numValues)
+            workspace.activations[i].resize(numValues);
+
+        // The input layer has no weights
+        if (i > 0) {
+            if (workspace.deltas[i].size() < numValues)
+                workspace.deltas[i].resize(numValues);
+
+            if (workspace.gradients[i].size() != layer.numWeights())
+                workspace.gradients[i].resize(layer.numWeights());
+        }
+    }
+}
+
+template<typename T>
+T BasicNeuralNet<T>::computeGradients(const T* inputs, const T* expectedOutputs, size_t batchSize,
+                                      BasicWorkspace<T>& workspace) const {
+    return this->computeGradients(inputs, expectedOutputs, batchSize, workspace, false);
+}
+
+template<typename T>
+T BasicNeuralNet<T>::computeGradientsRelaxed(const T* inputs, const T* expectedOutputs, size_t batchSize,
+                                             BasicWorkspace<T>& workspace) const {
+    workspace.weights.resize(this->layers.size());
+
+    // Other threads store to the shared weights, every weight is read once with a relaxed atomic load
+    for (size_t L = 1; L < this->layers.size(); ++L) {
+        const BasicLayer<T>& layer = this->layers[L];
+        vector<T>& copy = workspace.weights[L];
+
+        if (copy.size() != layer.numWeights())
+            copy.resize(layer.numWeights());
+
+        for (size_t i = 0; i < layer.numWeights(); ++i)
+            __atomic_load(&layer.weights[i], &copy[i], __ATOMIC_RELAXED);
+    }
+
+    return this->computeGradients(inputs, expectedOutputs, batchSize, workspace, true);
+}
+
+template<typename T>
+T BasicNeuralNet<T>::computeGradients(const T* inputs, const T* expectedOutputs, size_t batchSize,
+                                      BasicWorkspace<T>& workspace, bool copiedWeights) const {
+    SigmoidMode mode = this->getTrainingSigmoidMode();
+
+    // The weights of layer L, either the shared ones or the copy in the workspace
+    auto weights = [&](size_t L) -> const T* {
+        return copiedWeights ? workspace.weights[L].data() : this->layers[L].weights;
+    };
+    size_t numLayers = this->layers.size();
+    T standardError = 0;
+
+    this->prepareWorkspace(workspace, batchSize);
 
     //
-    // Calculate and correct the errors of the hidden layers
+    // Forward pass of the whole batch (one matrix-matrix product per layer)
     //
 
-    for (size_t L = this->numHiddenLayers; L > 0; L--) {
-        Layer* hl = this->layers[L];
-        Layer* prevHl = this->layers[L - 1];
-        Layer* nextHl = this->layers[L + 1];
+    this->activate(batchSize * this->layers[0].numNeurons, inputs, workspace.activations[0].data(), mode);
 
-        for (size_t j = 0; j < hl->numNeurons; j++) {
-            Neuron* nj = hl->neurons[j];
-            double err_j = 0;
+    for (size_t i = 1; i < numLayers; ++i) {
+        const BasicLayer<T>& li = this->layers[i];
+        const BasicLayer<T>& prev = this->layers[i - 1];
+        T* a = workspace.activations[i].data();
 
-            // Calculate the errors of the neuron j
-            for (size_t i = 0; i < nextHl->numNeurons; i++) {
-                err_j += nextHl->neurons[i]->weights[j] * delta_i[i];
+        // A single sample does not pay off the packing of gemm
+        if (batchSize == 1)
+            gemv(li.numNeurons, prev.numNeurons, 1, weights(i), li.numInputs, workspace.activations[i - 1].data(), 0, a);
+        else
+            gemm(false, true, batchSize, li.numNeurons, prev.numNeurons, 1, workspace.activations[i - 1].data(),
+                 prev.numNeurons, weights(i), li.numInputs, 0, a, li.numNeurons);
+
+        if (this->useBias && li.hasBias) {
+            for (size_t b = 0; b < batchSize; ++b) {
+                T* row = a + b * li.numNeurons;
+
+                for (size_t j = 0; j < li.numNeurons; ++j)
+                    row[j] += weights(i)[j * li.numInputs + li.numInputs - 1] * this->biasValue;
             }
+        }
+
+        this->activate(batchSize * li.numNeurons, a, a, mode);
+    }
+
+    //
+    // Error values of the output layer
+    //
+
+    const BasicLayer<T>& outputLayer = this->layers.back();
+
+    for (size_t b = 0; b < batchSize; ++b) {
+        const T* a = &workspace.activations.back()[b * outputLayer.numNeurons];
+        const T* y = expectedOutputs + b * outputLayer.numNeurons;
+        T* delta = &workspace.deltas.back()[b * outputLayer.numNeurons];
+        T err_b = 0;
+
+        for (size_t i = 0; i < outputLayer.numNeurons; ++i) {
+            T err = y[i] - a[i];
+            err_b += err;
+            delta[i] = err * a[i] * (1 - a[i]);
+        }
+
+        err_b /= outputLayer.numNeurons;
+        standardError += (err_b * err_b) / 2;
+    }
 
-            double net_j = nj->netInput;
-            double dj = this->sigmoidDerivation(net_j) * err_j;
-            delta_j.push_back(dj);
+    //
+    // Error values of the hidden layers: delta_L (batchSize x n_L) = delta_L+1 * W_L+1
+    //
+
+    for (size_t L = numLayers - 2; L > 0; --L) {
+        const BasicLayer<T>& hl = this->layers[L];
+        const BasicLayer<T>& nextHl = this->layers[L + 1];
+        const T* a = workspace.activations[L].data();
+        T* delta = workspace.deltas[L].data();
+
+        if (batchSize == 1)
+            gemvTransposed(nextHl.numNeurons, hl.numNeurons, 1, weights(L + 1), nextHl.numInputs,
+                           workspace.deltas[L + 1].data(), 0, delta);
+        else
+            gemm(false, false, batchSize, hl.numNeurons, nextHl.numNeurons, 1, workspace.deltas[L + 1].data(),
+                 nextHl.numNeurons, weights(L + 1), nextHl.numInputs, 0, delta, hl.numNeurons);
 
-            // Correct the weights between the hidden layer and the predecessor layer
+        for (size_t j = 0; j < batchSize * hl.numNeurons; ++j)
+            delta[j] *= a[j] * (1 - a[j]);
+    }
 
-            size_t numInputsJ = nj->numInputs;
-            for (size_t k = 0; k < numInputsJ; k++) {
-                double net_k;
+    //
+    // Gradients of all layers: G_L (n_L x n_L-1) = delta_L^T * a_L-1, summed over the batch
+    //
 
-                // Does the layer have a bias and is j the bias neuron?
-                if (hl->hasBias && k == numInputsJ - 1) {
-                    net_k = this->biasValue;
-                } else {
-                    net_k = prevHl->neurons[k]->netInput;
+    for (size_t L = 1; L < numLayers; ++L) {
+        const BasicLayer<T>& li = this->layers[L];
+        const BasicLayer<T>& prev = this->layers[L - 1];
+        const T* delta = workspace.deltas[L].data();
+        T* gradients = workspace.gradients[L].data();
+
+        if (batchSize == 1) {
+            fill(gradients, gradients + li.numWeights(), T(0));
+            ger(li.numNeurons, prev.numNeurons, 1, delta, workspace.activations[L - 1].data(), gradients, li.numInputs);
+        } else {
+            gemm(true, false, li.numNeurons, prev.numNeurons, batchSize, 1, delta, li.numNeurons,
+                 workspace.activations[L - 1].data(), prev.numNeurons, 0, gradients, li.numInputs);
+        }
+
+        // The input of the bias weight is the bias value
+        if (li.hasBias) {
+            for (size_t i = 0; i < li.numNeurons; ++i) {
+                T sum = 0;
+
+                if (this->useBias) {
+                    for (size_t b = 0; b < batchSize; ++b)
+                        sum += delta[b * li.numNeurons + i];
                 }
-                double delta_w = this->learningRate * this->sigmoid(net_k) * dj + this->momentum * nj->deltaWeights[k];
 
-                hl->neurons[j]->deltaWeights[k] = delta_w;
-                hl->neurons[j]->weights[k] += delta_w;
+                gradients[i * li.numInputs + li.numInputs - 1] = this->biasValue * sum;
             }
         }
-
-        delta_i = delta_j;
-        delta_j.clear();
     }
 
     return standardError;
 }
 
-void NeuralNet::setLearningRate(double value) {
+template<typename T>
+void BasicNeuralNet<T>::applyGradients(const BasicWorkspace<T>& workspace, T gradientScale) {
+    for (size_t L = 1; L < this->layers.size(); ++L) {
+        BasicLayer<T>& layer = this->layers[L];
+
+        // The accumulated rank-k update and the momentum in one pass over the delta weights and the weights
+        momentumUpdate(layer.numWeights(), this->learningRate * gradientScale, workspace.gradients[L].data(),
+                       this->momentum, layer.deltaWeights, layer.weights);
+    }
+
+    this->countUpdate();
+}
+
+template<typename T>
+void BasicNeuralNet<T>::applyGradientsRelaxed(const BasicWorkspace<T>& workspace, T gradientScale) {
+    T rate = this->learningRate * gradientScale;
+
+    for (size_t L = 1; L < this->layers.size(); ++L) {
+        BasicLayer<T>& layer = this->layers[L];
+        const T* gradients = workspace.gradients[L].data();
+
+        for (size_t i = 0; i < layer.numWeights(); ++i) {
+            T weight;
+            __atomic_load(&layer.weights[i], &weight, __ATOMIC_RELAXED);
+            weight += rate * gradients[i];
+            __atomic_store(&layer.weights[i], &weight, __ATOMIC_RELAXED);
+        }
+    }
+
+    // The snapshots are taken by one thread in checkpointRelaxed()
+    if (this->checkpointer != 0)
+        __atomic_add_fetch(&this->numUpdates, 1, __ATOMIC_RELAXED);
+}
+
+template<typename T>
+void BasicNeuralNet<T>::setLearningRate(T value) {
     this->learningRate = value;
 }
 
-double NeuralNet::getLearningRate() const {
+template<typename T>
+T BasicNeuralNet<T>::getLearningRate() const {
     return this->learningRate;
 }
 
-void NeuralNet::setMomentum(double value) {
+template<typename T>
+void BasicNeuralNet<T>::setMomentum(T value) {
     this->momentum = value;
 }
 
-double NeuralNet::getMomentum() const {
+template<typename T>
+T BasicNeuralNet<T>::getMomentum() const {
     return this->momentum;
 }
 
-void NeuralNet::setBiasValue(double bias) {
+template<typename T>
+void BasicNeuralNet<T>::setBiasValue(T bias) {
     this->biasValue = bias;
 }
 
-double NeuralNet::getBiasValue() const {
+template<typename T>
+T BasicNeuralNet<T>::getBiasValue() const {
     return this->biasValue;
 }
 
-void NeuralNet::setBiasStatus(const bool useBias) {
+template<typename T>
+void BasicNeuralNet<T>::setBiasStatus(const bool useBias) {
     this->useBias = useBias;
 }
 
-bool NeuralNet::getBiasStatus() const {
+template<typename T>
+bool BasicNeuralNet<T>::getBiasStatus() const {
     return this->useBias;
 }
 
-bool NeuralNet::save(const string& filename) {
+template<typename T>
+void BasicNeuralNet<T>::setSigmoidMode(SigmoidMode mode) {
+    this->sigmoidMode = mode;
+}
+
+template<typename T>
+typename BasicNeuralNet<T>::SigmoidMode BasicNeuralNet<T>::getSigmoidMode() const {
+    return this->sigmoidMode;
+}
+
+template<typename T>
+bool BasicNeuralNet<T>::save(const string& filename) {
     cout << "Exporting neural network " << this->name << " to " << filename << " ..." << endl;
 
-    Json::Value jsonNN;
-    jsonNN["useBias"] = this->useBias;
-    jsonNN["biasValue"] = this->biasValue;
-    jsonNN["layers"] = Json::Value(Json::arrayValue);
+    ofstream out(filename.c_str());
+    if (!out.is_open())
+        return false;
+
+    // The weights are written straight from the layers with the keys in alphabetical order
+    out << "{\"biasValue\":";
+    writeNumber(out, this->biasValue);
+    out << ",\"layers\":[";
 
     for (size_t layerIndex = 0; layerIndex < this->numHiddenLayers + 2; layerIndex++) {
-        Layer* layer = this->layers[layerIndex];
-        Json::Value jsonLayer;
+        const BasicLayer<T>* layer = &this->layers[layerIndex];
+        const char* type;
 
         if (layerIndex == 0)
-            jsonLayer["type"] = "input";
+            type = "input";
         else if (layerIndex == this->numHiddenLayers + 1)
-            jsonLayer["type"] = "output";
+            type = "output";
         else
-            jsonLayer["type"] = "hidden";
+            type = "hidden";
 
-        jsonLayer["hasBias"] = layer->hasBias;
-        jsonLayer["neurons"] = Json::Value(Json::arrayValue);
+        if (layerIndex > 0)
+            out << ',';
+
+        out << "{\"hasBias\":" << (layer->hasBias ? "true" : "false") << ",\"neurons\":[";
 
         for (size_t i = 0; i < layer->numNeurons; i++) {
-            Json::Value jsonNeuron;
-            jsonNeuron["weights"] = Json::Value(Json::arrayValue);
+            out << (i > 0 ? ",{\"weights\":[" : "{\"weights\":[");
+
+            const T* weights = layer->weightsOf(i);
+            for (size_t j = 0; j < layer->numInputs; j++) {
+                if (j > 0)
+                    out << ',';
 
-            for (size_t j = 0; j < layer->neurons[i]->numInputs; j++)
-                jsonNeuron["weights"].append(layer->neurons[i]->weights[j]);
+                writeNumber(out, weights[j]);
+            }
 
-            jsonLayer["neurons"].append(jsonNeuron);
+            out << "]}";
         }
 
-        jsonNN["layers"].append(jsonLayer);
+        out << "],\"type\":\"" << type << "\"}";
     }
 
-    ofstream out(filename.c_str());
-    if (!out.is_open())
+    out << "],\"scalarType\":\"" << scalarTypeName<T>() << "\",\"useBias\":" << (this->useBias ? "true" : "false") << "}\n";
+    out.close();
+
+    return !out.fail();
+}
+
+template<typename T>
+bool BasicNeuralNet<T>::saveBinary(const string& filename, bool includeDeltaWeights) {
+    cout << "Exporting neural network " << this->name << " to " << filename << " ..." << endl;
+
+    // The weights and the delta weights are stored in the layout of the arena
+    const BasicLayer<T>& firstLayer = this->layers[1];
+    const char* weights = reinterpret_cast<const char*>(firstLayer.weights);
+    const char* deltaWeights = includeDeltaWeights ? reinterpret_cast<const char*>(firstLayer.deltaWeights) : 0;
+
+    return writeBinaryModel(filename, this->getTopology(), sizeof(T), weights, deltaWeights);
+}
+
+template<typename T>
+bool BasicNeuralNet<T>::load(const string& filename) {
+    cout << "Loading " << filename << " ..." << endl;
+
+    if (isBinaryModel(filename))
+        return this->loadBinary(filename);
+
+    ModelReader reader;
+    if (!reader.open(filename))
         return false;
 
-    Json::FastWriter jsonWriter;
-    out << jsonWriter.write(jsonNN);
-    out.close();
+    // The weights are converted into temporary buffers first, so a file which turns out to be
+    // malformed in the second pass leaves the network unchanged. The delta weights start at zero.
+    const ModelTopology& topology = reader.getTopology();
+    vector<vector<T>> weights(topology.layerSizes.size());
+    vector<T*> layerWeights;
+
+    for (size_t i = 0; i < topology.layerSizes.size(); ++i) {
+        size_t numInputs = i == 0 ? 0 : topology.layerSizes[i - 1] + (topology.layerBiases[i] ? 1 : 0);
+        weights[i].resize(topology.layerSizes[i] * numInputs);
+        layerWeights.push_back(weights[i].data());
+    }
+
+    if (!reader.readWeights(layerWeights))
+        return false;
+
+    this->createLayers(topology);
+
+    for (size_t i = 0; i < this->layers.size(); ++i)
+        copy(weights[i].begin(), weights[i].end(), this->layers[i].weights);
 
     return true;
 }
 
-bool NeuralNet::load(const string& filename) {
-    cout << "Loading " << filename << " ..." << endl;
-    cerr << "Not implemented yet" << endl;
+template<typename T>
+bool BasicNeuralNet<T>::loadBinary(const string& filename) {
+    MappedFile file;
+    BinaryModelHeader header;
+    ModelTopology topology;
+
+    if (!file.open(filename) || !readBinaryModel(file.data(), file.size(), header, topology))
+        return false;
+
+    this->createLayers(topology);
+
+    vector<T*> layerWeights, layerDeltaWeights;
+    for (BasicLayer<T>& layer : this->layers) {
+        layerWeights.push_back(layer.weights);
+        layerDeltaWeights.push_back(layer.deltaWeights);
+    }
+
+    readBinaryModelSection(file.data() + header.weightsOffset, topology, header.scalarSize, layerWeights);
+
+    if (header.hasDeltaWeights)
+        readBinaryModelSection(file.data() + header.deltaWeightsOffset, topology, header.scalarSize, layerDeltaWeights);
+
     return true;
 }
+
+template<typename T>
+void BasicNeuralNet<T>::createLayers(const ModelTopology& topology) {
+    this->useBias = topology.useBias;
+    this->biasValue = (T) topology.biasValue;
+    this->numHiddenLayers = topology.layerSizes.size() - 2;
+    this->layers.clear();
+    this->workspace = BasicWorkspace<T>();
+
+    for (size_t i = 0; i < topology.layerSizes.size(); ++i) {
+        size_t numInputs = i == 0 ? 0 : topology.layerSizes[i - 1];
+        this->layers.push_back(BasicLayer<T>(topology.layerSizes[i], numInputs, topology.layerBiases[i]));
+    }
+
+    this->allocate();
+}
+
+template<typename T>
+ModelTopology BasicNeuralNet<T>::getTopology() const {
+    ModelTopology topology;
+    topology.scalarType = scalarTypeName<T>();
+    topology.useBias = this->useBias;
+    topology.biasValue = this->biasValue;
+
+    for (const BasicLayer<T>& layer : this->layers) {
+        topology.layerSizes.push_back(layer.numNeurons);
+        topology.layerBiases.push_back(layer.hasBias);
+    }
+
+    return topology;
+}
+
+template class BasicNeuralNet<float>;
+template class BasicNeuralNet<double>;
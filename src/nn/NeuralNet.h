@@ -1,7 +1,8 @@
 /**
 * NeuralNetwork
 *
-* This class represents a neural network layer with a fixed size.
+* This class represents a neural network layer with a fixed size. The scalar type of the weights,
+* inputs and outputs is a template parameter, NeuralNet is the double precision network.
 *
 * @author Shivan Taher
 * @date 22.03.2009
@@ -13,62 +14,180 @@
 #include <iostream>
 #include <vector>
 
+#include "Arena.h"
+#include "BatchPipeline.h"
+#include "Dataset.h"
 #include "Layer.h"
+#include "ModelReader.h"
+#include "ThreadPool.h"
+#include "Workspace.h"
 
 using namespace std;
 
-class NeuralNet {
+template<typename T>
+class BasicCheckpointer;
+
+/**
+* The parts of the neural network which do not depend on the scalar type
+*/
+class NeuralNetBase {
+public:
+    /**
+    * Evaluation of the sigmoid function: EXACT uses exp of the C library, FAST a vectorised
+    * polynomial approximation with a maximum absolute error of 2e-9 (2e-7 for float) and TABLE an
+    * interpolated lookup table with a maximum absolute error of 8e-7 (1e-6 for float). TABLE is
+    * only used for inference, the training falls back to EXACT.
+    */
+    enum SigmoidMode { EXACT, FAST, TABLE };
+
+    /**
+    * Layers with at least this many weights are split across the thread pool in the forward pass,
+    * smaller layers are calculated by the calling thread
+    */
+    static const size_t PARALLEL_THRESHOLD = 1 << 16;
+};
+
+template<typename T>
+class BasicNeuralNet : public NeuralNetBase {
 public:
-    NeuralNet(const string& name);
-    ~NeuralNet();
+    BasicNeuralNet(const string& name);
+    ~BasicNeuralNet();
 
-    void add(Layer::Type layerType, size_t numNeurons);
+    void add(LayerBase::Type layerType, size_t numNeurons);
 
     /**
     * Sends the signals (inputs) through the neural network und
     * returns the calculated output values.
     */
-    const vector<double>& calculateOutputs(vector<double> inputs);
+    const vector<T>& calculateOutputs(const vector<T>& inputs);
+
+    /**
+    * Sends numInputs signals through the neural network and returns a pointer to the output values,
+    * or a null pointer if numInputs does not match the input layer. Every layer writes into its
+    * preallocated activation buffer in the arena, so this never allocates memory. The returned
+    * pointer stays valid until the next call.
+    */
+    const T* calculateOutputs(const T* inputs, size_t numInputs);
+
+    /**
+    * Sends a batch of signals through the neural network. The inputs are a row-major
+    * batchSize x inputs matrix, the result is a row-major batchSize x outputs matrix.
+    * Every layer is computed as one matrix-matrix product for the whole batch.
+    */
+    const vector<T>& calculateOutputsBatch(const vector<T>& inputs, size_t batchSize);
+
+    /**
+    * Sends a batch of batchSize x inputs signals through the neural network and returns a pointer
+    * to the batchSize x outputs results. The pointer stays valid until the next batch call.
+    */
+    const T* calculateOutputsBatch(const T* inputs, size_t batchSize);
 
     /**
     * Returns the last output values
     */
-    const vector<double>& getOutputs() const;
+    const vector<T>& getOutputs() const;
 
     /**
     * Applies the backpropagation algorithm to the neural network and returns the standard error.
     */
-    double backpropagation(const vector<double>& inputs, const vector<double>& expectedOutputs);
+    T backpropagation(const vector<T>& inputs, const vector<T>& expectedOutputs);
+
+    /**
+    * Trains the network with one batch of samples: the gradients of all samples are accumulated
+    * and the weights are updated once with the mean gradient. The inputs and the expected outputs
+    * are row-major matrices with one sample per row. Returns the mean standard error of the batch.
+    */
+    T trainBatch(const vector<T>& inputs, const vector<T>& expectedOutputs);
+
+    /**
+    * Trains the network with batchSize samples, see trainBatch above
+    */
+    T trainBatch(const T* inputs, const T* expectedOutputs, size_t batchSize);
+
+    /**
+    * Trains the network epochs times with all samples of the dataset, split into batches of
+    * batchSize samples (the last batch may be smaller). Returns the mean standard error of the last
+    * epoch.
+    */
+    T train(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network with numSamples samples, see train above
+    */
+    T train(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network with all samples of a dataset, see train above. Returns 0 if the dataset
+    * does not match the input and the output layer.
+    */
+    T train(const BasicDataset<T>& dataset, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network epochs times with the batches of the pipeline, which must be at the
+    * beginning of an epoch. Returns the mean standard error of the last epoch.
+    */
+    T train(BasicBatchPipeline<T>& pipeline, size_t epochs);
+
+    /**
+    * Calculates the forward and the backward pass of a batch in the workspace and stores the
+    * accumulated negative gradients of all weights in workspace.gradients. Returns the summed
+    * standard error of the batch. The network is not modified, so several workspaces can be
+    * computed at the same time.
+    */
+    T computeGradients(const T* inputs, const T* expectedOutputs, size_t batchSize,
+                       BasicWorkspace<T>& workspace) const;
+
+    /**
+    * Like computeGradients, but the weights are first copied into workspace.weights with relaxed
+    * atomic loads and the passes run on that copy, so other threads may update the weights with
+    * applyGradientsRelaxed at the same time
+    */
+    T computeGradientsRelaxed(const T* inputs, const T* expectedOutputs, size_t batchSize,
+                              BasicWorkspace<T>& workspace) const;
+
+    /**
+    * Updates the weights with accumulated gradients:
+    * delta_w = learningRate * gradientScale * gradient + momentum * delta_w(t - 1), w += delta_w
+    */
+    void applyGradients(const BasicWorkspace<T>& workspace, T gradientScale);
+
+    /**
+    * Adds learningRate * gradientScale * gradient to the weights without locks for asynchronous
+    * (Hogwild) training. Every weight is read and written with relaxed atomic operations, so
+    * concurrent calls and concurrent computeGradientsRelaxed calls are allowed, but an update may
+    * overwrite the update of another thread. Momentum is not applied.
+    */
+    void applyGradientsRelaxed(const BasicWorkspace<T>& workspace, T gradientScale);
 
     /**
     * Sets the learning rate for the backpropagation algorithm.
     */
-    void setLearningRate(double value);
+    void setLearningRate(T value);
 
     /**
     * Returns the learning rate of the backpropagation algorithm.
     */
-    double getLearningRate() const;
+    T getLearningRate() const;
 
     /**
     * Sets the momentum value (Trägheitsterm)
     */
-    void setMomentum(double value);
+    void setMomentum(T value);
 
     /**
     * Returns the momentum value (Trägheitsterm)
     */
-    double getMomentum() const;
+    T getMomentum() const;
 
     /**
     * Sets the bias values - 0 ignores the bias
     */
-    void setBiasValue(double bias);
+    void setBiasValue(T bias);
 
     /**
     * Returns the bias value
     */
-    double getBiasValue() const;
+    T getBiasValue() const;
 
     /**
     * Enables or disables the bias
@@ -81,36 +200,184 @@ public:
     bool getBiasStatus() const;
 
     /**
-    * Saves the neural network as a JSON file
+    * Selects how the sigmoid function is evaluated in the forward pass and in training
+    */
+    void setSigmoidMode(SigmoidMode mode);
+
+    /**
+    * Returns how the sigmoid function is evaluated
+    */
+    SigmoidMode getSigmoidMode() const;
+
+    /**
+    * Sets the thread pool which calculates the neurons of wide layers in parallel in the forward
+    * pass of a single sample (see PARALLEL_THRESHOLD). The pool is not owned by the network,
+    * 0 disables the parallel calculation.
+    */
+    void setThreadPool(ThreadPool* pool);
+
+    /**
+    * Sets the checkpointer which takes a snapshot of the network after every interval weight
+    * updates. Every call of backpropagation(), applyGradients() (used by trainBatch(), train()
+    * and ParallelTrainer::train()) and applyGradientsRelaxed() (ParallelTrainer::trainAsync()) is
+    * one update. The checkpointer is not owned by the network, 0 disables the checkpoints.
+    */
+    void setCheckpointer(BasicCheckpointer<T>* checkpointer, size_t interval);
+
+    /**
+    * Takes a snapshot with relaxed atomic loads if interval updates of applyGradientsRelaxed()
+    * have been counted since the last one. Called by one of the asynchronous training threads
+    * while the others update the weights.
+    */
+    void checkpointRelaxed();
+
+    /**
+    * Returns the number of layers including the input and the output layer
+    */
+    size_t getNumLayers() const;
+
+    /**
+    * Returns the layer with the given index (0 is the input layer)
+    */
+    const BasicLayer<T>& getLayer(size_t index) const;
+
+    /**
+    * Returns the number of neurons of the input layer
+    */
+    size_t getNumInputs() const;
+
+    /**
+    * Returns the number of neurons of the output layer
+    */
+    size_t getNumOutputs() const;
+
+    /**
+    * Returns the arena which holds all weights, delta weights, net inputs and activations
+    */
+    const Arena& getArena() const;
+
+    /**
+    * Returns the number of weights of the network
+    */
+    size_t getNumParameters() const;
+
+    /**
+    * Returns the topology and the bias settings of the network
+    */
+    ModelTopology getTopology() const;
+
+    /**
+    * Saves the neural network as a JSON file (including the scalar type)
     */
     bool save(const string& filename);
 
     /**
-    * Loads the neural network from a JSON file
+    * Saves the neural network in the binary model format (see BinaryModel.h), optionally with the
+    * delta weights so the training can be continued with the same momentum
+    */
+    bool saveBinary(const string& filename, bool includeDeltaWeights = false);
+
+    /**
+    * Loads the neural network from a JSON file written by save() or a binary file written by
+    * saveBinary(). The topology of the network is replaced by the one of the file. If the file can
+    * not be read, false is returned and the network is left unchanged.
     */
     bool load(const string& filename);
 
     /**
     * Sigmoid function (activation function)
     */
-    inline double sigmoid(double x);
+    T sigmoid(T x);
 
     /**
     * The first derivation of the sigmoid function
     */
-    inline double sigmoidDerivation(double x);
+    T sigmoidDerivation(T x);
 
 private:
+    BasicNeuralNet(const BasicNeuralNet&);
+    BasicNeuralNet& operator=(const BasicNeuralNet&);
+
+    /**
+    * Places the buffers of all layers in the arena (all values are zero)
+    */
+    void allocate();
+
+    /**
+    * Replaces the layers and the bias settings with the given topology and allocates the arena
+    */
+    void createLayers(const ModelTopology& topology);
+
+    /**
+    * Loads a file in the binary model format
+    */
+    bool loadBinary(const string& filename);
+
+    /**
+    * Calculates the net inputs and the activations of all layers for one sample
+    */
+    const T* forward(const T* inputs, SigmoidMode mode);
+
+    /**
+    * Calculates the net inputs and the activations of the neurons [first, last) of layer i
+    */
+    void forwardNeurons(size_t i, size_t first, size_t last, SigmoidMode mode);
+
+    /**
+    * Applies the sigmoid function to n net inputs
+    */
+    void activate(size_t n, const T* netInputs, T* activations, SigmoidMode mode) const;
+
+    /**
+    * Returns the sigmoid mode used for training
+    */
+    SigmoidMode getTrainingSigmoidMode() const;
+
+    /**
+    * Applies the weight changes of one layer for the given error values
+    */
+    void updateWeights(BasicLayer<T>* layer, const BasicLayer<T>* prevLayer, const T* deltas);
+
+    /**
+    * Calculates the gradients of a batch with the weights of the layers or, if copiedWeights is
+    * set, with the copy in workspace.weights, see computeGradients
+    */
+    T computeGradients(const T* inputs, const T* expectedOutputs, size_t batchSize, BasicWorkspace<T>& workspace,
+                       bool copiedWeights) const;
+
+    /**
+    * Counts a weight update and takes a snapshot every checkpointInterval updates
+    */
+    void countUpdate();
+
+    /**
+    * Sizes the buffers of the workspace for batchSize samples
+    */
+    void prepareWorkspace(BasicWorkspace<T>& workspace, size_t batchSize) const;
+
     size_t numHiddenLayers;
 
-    double momentum;
-    double learningRate;
-    double biasValue;
+    T momentum;
+    T learningRate;
+    T biasValue;
     bool useBias;
+    SigmoidMode sigmoidMode;
+    ThreadPool* pool;
+    BasicCheckpointer<T>* checkpointer;
+    size_t checkpointInterval;
+    size_t numUpdates;
+    size_t lastCheckpoint;
 
-    vector<Layer*> layers;
-    vector<double> outputs;
+    vector<BasicLayer<T>> layers;
+    Arena arena;
+    vector<T> outputs;
+    vector<T> batchOutputs;
+    vector<T> batchBuffers[2];
+    vector<T> deltaBuffers[2];
+    BasicWorkspace<T> workspace;
     string name;
 };
 
+typedef BasicNeuralNet<double> NeuralNet;
+
 #endif
@@ -1,7 +1,9 @@
 /**
 * Neuron
 *
-* The Neuron class represents a single neuron with its weights to the neighbours.
+* The Neuron class is a lightweight view on a single row of a layer's weight matrix. The weights
+* themselves are owned by the Layer; the view only exists for compatibility with code that accesses
+* the network neuron by neuron.
 *
 * @author Shivan Taher
 * @date 22.03.2009
@@ -15,33 +17,36 @@
 
 using namespace std;
 
-class Neuron {
+template<typename T>
+class BasicNeuron {
 public:
-    Neuron();
+    BasicNeuron();
 
-    Neuron(size_t numInputs, bool hasBias = true);
+    BasicNeuron(T* weights, T* deltaWeights, T* netInput, size_t numInputs);
 
-    ~Neuron();
+    ~BasicNeuron();
 
     /**
     * Weights of the neuron / synapse in biological terms
     */
-    vector<double> weights;
+    T* weights;
 
     /**
     * The last changes of the weights - optimisation for the backpropagation algorithm
     */
-    vector<double> deltaWeights;
+    T* deltaWeights;
 
     /**
-    * The number of inputs of the neuron
+    * The number of inputs of the neuron (including the bias)
     */
     size_t numInputs;
 
     /**
     * The sum of all the inputs
     */
-    double netInput;
+    T* netInput;
 };
 
+typedef BasicNeuron<double> Neuron;
+
 #endif
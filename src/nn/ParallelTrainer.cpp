@@ -0,0 +1,266 @@
+/**
+* ParallelTrainer
+*
+* The implementation of the data-parallel trainer.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "ParallelTrainer.h"
+#include "Kernels.h"
+
+#include <algorithm>
+
+template<typename T>
+BasicParallelTrainer<T>::BasicParallelTrainer(BasicNeuralNet<T>& net, size_t numThreads)
+    : net(net),
+      numThreads(max(numThreads, size_t(1))),
+      workspaces(this->numThreads),
+      sliceSizes(this->numThreads),
+      errors(this->numThreads),
+      barrier(this->numThreads),
+      inputs(0),
+      expectedOutputs(0),
+      numSamples(0),
+      async(false),
+      stopped(false)
+{
+    // The calling thread is the first worker
+    for (size_t worker = 1; worker < this->numThreads; ++worker)
+        this->threads.push_back(thread(&BasicParallelTrainer<T>::run, this, worker));
+}
+
+template<typename T>
+BasicParallelTrainer<T>::~BasicParallelTrainer() {
+    this->stopped = true;
+    this->barrier.wait();
+
+    for (thread& worker : this->threads)
+        worker.join();
+}
+
+template<typename T>
+size_t BasicParallelTrainer<T>::getNumThreads() const {
+    return this->numThreads;
+}
+
+template<typename T>
+void BasicParallelTrainer<T>::run(size_t worker) {
+    while (true) {
+        // Wait for the next batch
+        this->barrier.wait();
+
+        if (this->stopped)
+            return;
+
+        if (this->async)
+            this->processSamples(worker);
+        else
+            this->processSlice(worker);
+    }
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::trainBatch(const T* inputs, const T* expectedOutputs, size_t batchSize) {
+    if (batchSize == 0)
+        return 0;
+
+    // The first batchSize % numThreads workers get one sample more
+    for (size_t worker = 0; worker < this->numThreads; ++worker)
+        this->sliceSizes[worker] = batchSize / this->numThreads + (worker < batchSize % this->numThreads ? 1 : 0);
+
+    this->inputs = inputs;
+    this->expectedOutputs = expectedOutputs;
+    this->async = false;
+
+    // Start the background workers and process the first slice
+    this->barrier.wait();
+    this->processSlice(0);
+
+    // The reduction has summed all gradients in the first workspace
+    this->net.applyGradients(this->workspaces[0], T(1) / batchSize);
+
+    T standardError = 0;
+    for (size_t worker = 0; worker < this->numThreads; ++worker)
+        standardError += this->errors[worker];
+
+    return standardError / batchSize;
+}
+
+template<typename T>
+void BasicParallelTrainer<T>::processSlice(size_t worker) {
+    size_t first = 0;
+    for (size_t i = 0; i < worker; ++i)
+        first += this->sliceSizes[i];
+
+    // Gradients of the slice
+    size_t sliceSize = this->sliceSizes[worker];
+    this->errors[worker] = 0;
+
+    if (sliceSize > 0) {
+        this->errors[worker] = this->net.computeGradients(this->inputs + first * this->net.getNumInputs(),
+                                                          this->expectedOutputs + first * this->net.getNumOutputs(),
+                                                          sliceSize, this->workspaces[worker]);
+    }
+
+    this->barrier.wait();
+
+    // Tree reduction: in step s every worker with an index divisible by 2s adds the gradients of the
+    // worker s places behind it. Empty slices are always at the end, so they are never added.
+    for (size_t stride = 1; stride < this->numThreads; stride *= 2) {
+        size_t partner = worker + stride;
+
+        if (worker % (2 * stride) == 0 && partner < this->numThreads && this->sliceSizes[partner] > 0) {
+            vector<vector<T>>& gradients = this->workspaces[worker].gradients;
+            const vector<vector<T>>& partnerGradients = this->workspaces[partner].gradients;
+
+            for (size_t L = 1; L < gradients.size(); ++L)
+                axpy(gradients[L].size(), 1, partnerGradients[L].data(), gradients[L].data());
+        }
+
+        this->barrier.wait();
+    }
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::train(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t batchSize,
+                                 size_t epochs) {
+    size_t numInputs = this->net.getNumInputs();
+    size_t numOutputs = this->net.getNumOutputs();
+    size_t numSamples = inputs.size() / numInputs;
+
+    // Check the size of the dataset
+    if (inputs.size() != numSamples * numInputs || expectedOutputs.size() != numSamples * numOutputs)
+        return 0;
+
+    return this->train(inputs.data(), expectedOutputs.data(), numSamples, batchSize, epochs);
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::train(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t batchSize,
+                                 size_t epochs) {
+    size_t numInputs = this->net.getNumInputs();
+    size_t numOutputs = this->net.getNumOutputs();
+
+    if (batchSize == 0 || numSamples == 0)
+        return 0;
+
+    T standardError = 0;
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        standardError = 0;
+
+        for (size_t first = 0; first < numSamples; first += batchSize) {
+            size_t n = min(batchSize, numSamples - first);
+            standardError += n * this->trainBatch(&inputs[first * numInputs], &expectedOutputs[first * numOutputs], n);
+        }
+
+        standardError /= numSamples;
+    }
+
+    return standardError;
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::train(const BasicDataset<T>& dataset, size_t batchSize, size_t epochs) {
+    if (dataset.getNumInputs() != this->net.getNumInputs() || dataset.getNumOutputs() != this->net.getNumOutputs())
+        return 0;
+
+    return this->train(dataset.getInputs(), dataset.getOutputs(), dataset.getNumSamples(), batchSize, epochs);
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::train(BasicBatchPipeline<T>& pipeline, size_t epochs) {
+    const BasicDataset<T>& dataset = pipeline.getDataset();
+
+    if (dataset.getNumSamples() == 0 || dataset.getNumInputs() != this->net.getNumInputs() || dataset.getNumOutputs() != this->net.getNumOutputs())
+        return 0;
+
+    T standardError = 0;
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        standardError = 0;
+
+        // The pipeline gathers the next batch while this one is trained
+        for (size_t n = pipeline.next(); n > 0; n = pipeline.next())
+            standardError += n * this->trainBatch(pipeline.getInputs(), pipeline.getOutputs(), n);
+
+        standardError /= dataset.getNumSamples();
+    }
+
+    return standardError;
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::trainAsync(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t epochs) {
+    size_t numInputs = this->net.getNumInputs();
+    size_t numOutputs = this->net.getNumOutputs();
+    size_t numSamples = inputs.size() / numInputs;
+
+    // Check the size of the dataset
+    if (inputs.size() != numSamples * numInputs || expectedOutputs.size() != numSamples * numOutputs)
+        return 0;
+
+    return this->trainAsync(inputs.data(), expectedOutputs.data(), numSamples, epochs);
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::trainAsync(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t epochs) {
+    if (numSamples == 0)
+        return 0;
+
+    this->inputs = inputs;
+    this->expectedOutputs = expectedOutputs;
+    this->numSamples = numSamples;
+    this->async = true;
+
+    T standardError = 0;
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        // Start the background workers and process the first share of the samples
+        this->barrier.wait();
+        this->processSamples(0);
+
+        standardError = 0;
+        for (size_t worker = 0; worker < this->numThreads; ++worker)
+            standardError += this->errors[worker];
+
+        standardError /= numSamples;
+    }
+
+    return standardError;
+}
+
+template<typename T>
+T BasicParallelTrainer<T>::trainAsync(const BasicDataset<T>& dataset, size_t epochs) {
+    if (dataset.getNumInputs() != this->net.getNumInputs() || dataset.getNumOutputs() != this->net.getNumOutputs())
+        return 0;
+
+    return this->trainAsync(dataset.getInputs(), dataset.getOutputs(), dataset.getNumSamples(), epochs);
+}
+
+template<typename T>
+void BasicParallelTrainer<T>::processSamples(size_t worker) {
+    size_t numInputs = this->net.getNumInputs();
+    size_t numOutputs = this->net.getNumOutputs();
+    BasicWorkspace<T>& workspace = this->workspaces[worker];
+
+    this->errors[worker] = 0;
+
+    for (size_t i = worker; i < this->numSamples; i += this->numThreads) {
+        this->errors[worker] += this->net.computeGradientsRelaxed(this->inputs + i * numInputs,
+                                                                  this->expectedOutputs + i * numOutputs, 1, workspace);
+        this->net.applyGradientsRelaxed(workspace, 1);
+
+        // The first worker takes the checkpoints
+        if (worker == 0)
+            this->net.checkpointRelaxed();
+    }
+
+    // Wait until the epoch is complete
+    this->barrier.wait();
+}
+
+template class BasicParallelTrainer<float>;
+template class BasicParallelTrainer<double>;
@@ -0,0 +1,131 @@
+/**
+* ParallelTrainer
+*
+* Data-parallel mini-batch training of a neural network. Every batch is split into one slice per
+* thread, each thread computes the gradients of its slice in its own workspace, the gradients are
+* summed with a parallel tree reduction and the weights of the network are updated once per batch.
+* The calling thread takes part as the first worker. Alternatively trainAsync() runs lock-free
+* per-sample updates (Hogwild) on the shared weights.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_PARALLEL_TRAINER_H
+#define _NEURAL_PARALLEL_TRAINER_H
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Barrier.h"
+#include "BatchPipeline.h"
+#include "Dataset.h"
+#include "NeuralNet.h"
+#include "Workspace.h"
+
+using namespace std;
+
+template<typename T>
+class BasicParallelTrainer {
+public:
+    /**
+    * Creates a trainer for the given network with numThreads worker threads (including the caller)
+    */
+    BasicParallelTrainer(BasicNeuralNet<T>& net, size_t numThreads);
+    ~BasicParallelTrainer();
+
+    /**
+    * Trains the network with one batch of batchSize samples (row-major inputs and expected outputs)
+    * and returns the mean standard error of the batch, see NeuralNet::trainBatch
+    */
+    T trainBatch(const T* inputs, const T* expectedOutputs, size_t batchSize);
+
+    /**
+    * Trains the network epochs times with all samples of the dataset and returns the mean standard
+    * error of the last epoch, see NeuralNet::train
+    */
+    T train(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network with numSamples samples, see train above
+    */
+    T train(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network with all samples of a dataset, see train above
+    */
+    T train(const BasicDataset<T>& dataset, size_t batchSize, size_t epochs);
+
+    /**
+    * Trains the network epochs times with the batches of the pipeline, which must be at the
+    * beginning of an epoch. Returns the mean standard error of the last epoch.
+    */
+    T train(BasicBatchPipeline<T>& pipeline, size_t epochs);
+
+    /**
+    * Trains the network epochs times with all samples of the dataset, updating the weights after
+    * every sample like backpropagation(). The threads process different samples at the same time
+    * and update the shared weights without locks or barriers (Hogwild). Both sides are atomic:
+    * every sample starts with a copy of the weights read with relaxed atomic loads
+    * (computeGradientsRelaxed) and the update reads and writes every weight with relaxed atomic
+    * operations (applyGradientsRelaxed). The input layer applies the sigmoid function, so every
+    * sample updates every weight and a concurrent update may be lost. The result is not
+    * deterministic and momentum is not applied. Returns the mean standard error of the last epoch.
+    */
+    T trainAsync(const vector<T>& inputs, const vector<T>& expectedOutputs, size_t epochs);
+
+    /**
+    * Trains the network asynchronously with numSamples samples, see trainAsync above
+    */
+    T trainAsync(const T* inputs, const T* expectedOutputs, size_t numSamples, size_t epochs);
+
+    /**
+    * Trains the network asynchronously with all samples of a dataset, see trainAsync above
+    */
+    T trainAsync(const BasicDataset<T>& dataset, size_t epochs);
+
+    /**
+    * Returns the number of worker threads (including the caller)
+    */
+    size_t getNumThreads() const;
+
+private:
+    BasicParallelTrainer(const BasicParallelTrainer&);
+    BasicParallelTrainer& operator=(const BasicParallelTrainer&);
+
+    /**
+    * The loop of the background workers: wait for a batch, process the slice, repeat
+    */
+    void run(size_t worker);
+
+    /**
+    * Computes the gradients of the slice of the given worker and takes part in the reduction
+    */
+    void processSlice(size_t worker);
+
+    /**
+    * Trains the network with every numThreads-th sample of the dataset, starting at the worker index
+    */
+    void processSamples(size_t worker);
+
+    BasicNeuralNet<T>& net;
+    size_t numThreads;
+
+    vector<thread> threads;
+    vector<BasicWorkspace<T>> workspaces;
+    vector<size_t> sliceSizes;
+    vector<T> errors;
+    Barrier barrier;
+
+    // The current batch or, in asynchronous mode, the dataset
+    const T* inputs;
+    const T* expectedOutputs;
+    size_t numSamples;
+    bool async;
+    bool stopped;
+};
+
+typedef BasicParallelTrainer<double> ParallelTrainer;
+
+#endif
@@ -0,0 +1,384 @@
+/**
+* QuantizedNet
+*
+* The implementation of the quantized network.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "QuantizedNet.h"
+#include "Kernels.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char QUANTIZED_MODEL_MAGIC[8] = "NNQUANT";
+static const uint32_t QUANTIZED_MODEL_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+* The file starts with this header, followed by every layer after the input layer: a
+* QuantizedLayerHeader, the weight scales and the biases of the neurons (double) and the weight
+* matrix (numNeurons x numInputs signed bytes)
+*/
+struct QuantizedModelHeader {
+    /**
+    * "NNQUANT" with a terminating 0
+    */
+    char magic[8];
+
+    uint32_t version;
+
+    /**
+    * 0x01020304 written in the byte order of the writer
+    */
+    uint32_t byteOrder;
+
+    /**
+    * Number of layers including the input layer
+    */
+    uint64_t numLayers;
+};
+
+struct QuantizedLayerHeader {
+    uint64_t numNeurons;
+    uint64_t numInputs;
+    double inputScale;
+};
+
+template<typename T>
+BasicQuantizedNet<T>::BasicQuantizedNet()
+    : maxNeurons(0),
+      sigmoidMode(NeuralNetBase::EXACT)
+{
+}
+
+template<typename T>
+BasicQuantizedNet<T>::~BasicQuantizedNet() {
+}
+
+template<typename T>
+bool BasicQuantizedNet<T>::quantize(const BasicNeuralNet<T>& net, const T* inputs, size_t numSamples) {
+    size_t numLayers = net.getNumLayers();
+    if (numSamples == 0 || numLayers < 2)
+        return false;
+
+    this->sigmoidMode = net.getSigmoidMode();
+
+    size_t maxNeurons = 0;
+    for (size_t L = 0; L < numLayers; ++L)
+        maxNeurons = max(maxNeurons, net.getLayer(L).numNeurons);
+
+    // The largest activation entering every layer, calculated with the floating point weights
+    vector<T> maxActivations(numLayers, 0);
+    vector<T> buffers[2] = { vector<T>(maxNeurons), vector<T>(maxNeurons) };
+    size_t numInputs = net.getNumInputs();
+
+    for (size_t sample = 0; sample < numSamples; ++sample) {
+        this->activate(numInputs, inputs + sample * numInputs, buffers[0].data());
+
+        for (size_t L = 1; L < numLayers; ++L) {
+            const BasicLayer<T>& layer = net.getLayer(L);
+            const T* layerInputs = buffers[(L - 1) % 2].data();
+            T* netInputs = buffers[L % 2].data();
+            size_t numLayerInputs = net.getLayer(L - 1).numNeurons;
+
+            for (size_t j = 0; j < numLayerInputs; ++j)
+                maxActivations[L] = max(maxActivations[L], layerInputs[j]);
+
+            if (L + 1 == numLayers)
+                break;
+
+            gemv(layer.numNeurons, numLayerInputs, 1, layer.weights, layer.numInputs, layerInputs, 0, netInputs);
+
+            if (net.getBiasStatus() && layer.hasBias) {
+                for (size_t i = 0; i < layer.numNeurons; ++i)
+                    netInputs[i] += layer.weightsOf(i)[layer.numInputs - 1] * net.getBiasValue();
+            }
+
+            this->activate(layer.numNeurons, netInputs, netInputs);
+        }
+    }
+
+    this->layers.assign(numLayers - 1, QuantizedLayer());
+
+    for (size_t L = 1; L < numLayers; ++L) {
+        const BasicLayer<T>& source = net.getLayer(L);
+        QuantizedLayer& layer = this->layers[L - 1];
+
+        layer.numNeurons = source.numNeurons;
+        layer.numInputs = net.getLayer(L - 1).numNeurons;
+        layer.inputScale = maxActivations[L] > 0 ? maxActivations[L] / 255 : 1;
+        layer.weightScales.resize(layer.numNeurons);
+        layer.biases.resize(layer.numNeurons);
+        layer.weights.resize(layer.numNeurons * layer.numInputs);
+
+        for (size_t i = 0; i < layer.numNeurons; ++i) {
+            const T* weights = source.weightsOf(i);
+
+            // Symmetric per-neuron scale, the largest weight becomes +-127
+            T maxWeight = 0;
+            for (size_t j = 0; j < layer.numInputs; ++j)
+                maxWeight = max(maxWeight, (T) fabs(weights[j]));
+
+            T scale = maxWeight > 0 ? maxWeight / 127 : 1;
+            layer.weightScales[i] = scale;
+
+            for (size_t j = 0; j < layer.numInputs; ++j)
+                layer.weights[i * layer.numInputs + j] = (int8_t) lrint(weights[j] / scale);
+
+            layer.biases[i] = net.getBiasStatus() && source.hasBias ? weights[source.numInputs - 1] * net.getBiasValue() : 0;
+        }
+    }
+
+    this->prepare();
+    return true;
+}
+
+template<typename T>
+bool BasicQuantizedNet<T>::quantize(const BasicNeuralNet<T>& net, const BasicDataset<T>& calibration) {
+    if (calibration.getNumInputs() != net.getNumInputs())
+        return false;
+
+    return this->quantize(net, calibration.getInputs(), calibration.getNumSamples());
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::prepare() {
+    this->maxNeurons = this->layers.empty() ? 0 : this->layers.front().numInputs;
+
+    for (QuantizedLayer& layer : this->layers) {
+        this->maxNeurons = max(this->maxNeurons, layer.numNeurons);
+
+        layer.outputScales.resize(layer.numNeurons);
+        for (size_t i = 0; i < layer.numNeurons; ++i)
+            layer.outputScales[i] = layer.weightScales[i] * layer.inputScale;
+    }
+}
+
+template<typename T>
+bool BasicQuantizedNet<T>::save(const string& filename) const {
+    if (this->layers.empty())
+        return false;
+
+    QuantizedModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, QUANTIZED_MODEL_MAGIC, sizeof(header.magic));
+    header.version = QUANTIZED_MODEL_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.numLayers = this->layers.size() + 1;
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == 0)
+        return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (const QuantizedLayer& layer : this->layers) {
+        QuantizedLayerHeader layerHeader = { layer.numNeurons, layer.numInputs, (double) layer.inputScale };
+        vector<double> weightScales(layer.weightScales.begin(), layer.weightScales.end());
+        vector<double> biases(layer.biases.begin(), layer.biases.end());
+
+        written = written && fwrite(&layerHeader, sizeof(layerHeader), 1, file) == 1 &&
+                  fwrite(weightScales.data(), sizeof(double), layer.numNeurons, file) == layer.numNeurons &&
+                  fwrite(biases.data(), sizeof(double), layer.numNeurons, file) == layer.numNeurons &&
+                  fwrite(layer.weights.data(), 1, layer.weights.size(), file) == layer.weights.size();
+    }
+
+    return fclose(file) == 0 && written;
+}
+
+template<typename T>
+bool BasicQuantizedNet<T>::load(const string& filename) {
+    MappedFile file;
+    QuantizedModelHeader header;
+
+    if (!file.open(filename) || file.size() < sizeof(header))
+        return false;
+
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (memcmp(header.magic, QUANTIZED_MODEL_MAGIC, sizeof(header.magic)) != 0 || header.version != QUANTIZED_MODEL_VERSION ||
+        header.byteOrder != BYTE_ORDER_MARK || header.numLayers < 2 ||
+        header.numLayers - 1 > (file.size() - sizeof(header)) / sizeof(QuantizedLayerHeader))
+        return false;
+
+    const char* position = file.data() + sizeof(header);
+    const char* end = file.data() + file.size();
+    vector<QuantizedLayer> layers(header.numLayers - 1);
+
+    for (size_t L = 0; L < layers.size(); ++L) {
+        QuantizedLayer& layer = layers[L];
+        QuantizedLayerHeader layerHeader;
+
+        if ((size_t) (end - position) < sizeof(layerHeader))
+            return false;
+
+        memcpy(&layerHeader, position, sizeof(layerHeader));
+        position += sizeof(layerHeader);
+
+        // Every layer must take the outputs of the one before and fit into the file. The sizes are
+        // divided before they are multiplied, so a corrupt header can not overflow them.
+        size_t remaining = end - position;
+
+        if (layerHeader.numNeurons == 0 || layerHeader.numInputs == 0 ||
+            (L > 0 && layerHeader.numInputs != layers[L - 1].numNeurons) ||
+            layerHeader.numNeurons > remaining / (2 * sizeof(double)))
+            return false;
+
+        remaining -= layerHeader.numNeurons * 2 * sizeof(double);
+
+        if (layerHeader.numInputs > remaining / layerHeader.numNeurons)
+            return false;
+
+        layer.numNeurons = layerHeader.numNeurons;
+        layer.numInputs = layerHeader.numInputs;
+        layer.inputScale = (T) layerHeader.inputScale;
+
+        vector<double> values(2 * layer.numNeurons);
+        memcpy(values.data(), position, values.size() * sizeof(double));
+        position += values.size() * sizeof(double);
+
+        layer.weightScales.assign(values.begin(), values.begin() + layer.numNeurons);
+        layer.biases.assign(values.begin() + layer.numNeurons, values.end());
+
+        layer.weights.resize(layer.numNeurons * layer.numInputs);
+        memcpy(layer.weights.data(), position, layer.weights.size());
+        position += layer.weights.size();
+    }
+
+    this->layers.swap(layers);
+    this->prepare();
+    return true;
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::quantizeInputs(const QuantizedLayer& layer, size_t n, const T* activations,
+                                          uint8_t* values) const {
+    T inverseScale = 1 / layer.inputScale;
+
+    // The activations are not negative, adding 0.5 before the truncation rounds to the nearest byte
+    for (size_t k = 0; k < n; ++k) {
+        T value = activations[k] * inverseScale + T(0.5);
+        values[k] = value >= 255 ? 255 : (value <= 0 ? 0 : (uint8_t) value);
+    }
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::activate(size_t n, const T* netInputs, T* activations) const {
+    if (this->sigmoidMode == NeuralNetBase::FAST)
+        sigmoidFast(n, netInputs, activations);
+    else if (this->sigmoidMode == NeuralNetBase::TABLE)
+        sigmoidTable(n, netInputs, activations);
+    else
+        sigmoidExact(n, netInputs, activations);
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::calculateOutputs(const T* inputs, T* outputs) const {
+    static thread_local vector<T> scratch;
+    static thread_local vector<uint8_t> values;
+    static thread_local vector<int32_t> sums;
+
+    if (scratch.size() < 2 * this->maxNeurons) {
+        scratch.resize(2 * this->maxNeurons);
+        values.resize(this->maxNeurons);
+        sums.resize(this->maxNeurons);
+    }
+
+    // The layers write alternately into the two halves of the scratch memory
+    T* buffers[2] = { scratch.data(), scratch.data() + this->maxNeurons };
+
+    // The input layer only applies the activation function
+    this->activate(this->getNumInputs(), inputs, buffers[0]);
+
+    for (size_t i = 0; i < this->layers.size(); ++i) {
+        const QuantizedLayer& layer = this->layers[i];
+        T* netInputs = i + 1 == this->layers.size() ? outputs : buffers[(i + 1) % 2];
+
+        this->quantizeInputs(layer, layer.numInputs, buffers[i % 2], values.data());
+        gemvInt8(layer.numNeurons, layer.numInputs, layer.weights.data(), layer.numInputs, values.data(), sums.data());
+
+        for (size_t j = 0; j < layer.numNeurons; ++j)
+            netInputs[j] = sums[j] * layer.outputScales[j] + layer.biases[j];
+
+        this->activate(layer.numNeurons, netInputs, netInputs);
+    }
+}
+
+template<typename T>
+vector<T> BasicQuantizedNet<T>::calculateOutputs(const vector<T>& inputs) const {
+    vector<T> outputs(this->getNumOutputs());
+    this->calculateOutputs(inputs.data(), outputs.data());
+    return outputs;
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::calculateOutputsBatch(const T* inputs, size_t batchSize, T* outputs) const {
+    static thread_local vector<T> scratch;
+    static thread_local vector<uint8_t> values;
+    static thread_local vector<int32_t> sums;
+
+    size_t batchNeurons = batchSize * this->maxNeurons;
+    if (scratch.size() < 2 * batchNeurons) {
+        scratch.resize(2 * batchNeurons);
+        values.resize(batchNeurons);
+        sums.resize(batchNeurons);
+    }
+
+    T* buffers[2] = { scratch.data(), scratch.data() + batchNeurons };
+
+    this->activate(batchSize * this->getNumInputs(), inputs, buffers[0]);
+
+    for (size_t i = 0; i < this->layers.size(); ++i) {
+        const QuantizedLayer& layer = this->layers[i];
+        T* netInputs = i + 1 == this->layers.size() ? outputs : buffers[(i + 1) % 2];
+
+        // The quantized samples are the rows of B, the results one row per sample
+        this->quantizeInputs(layer, batchSize * layer.numInputs, buffers[i % 2], values.data());
+        gemmInt8(layer.numNeurons, batchSize, layer.numInputs, layer.weights.data(), layer.numInputs, values.data(),
+                 layer.numInputs, sums.data(), layer.numNeurons);
+
+        for (size_t sample = 0; sample < batchSize; ++sample) {
+            const int32_t* sampleSums = sums.data() + sample * layer.numNeurons;
+            T* sampleInputs = netInputs + sample * layer.numNeurons;
+
+            for (size_t j = 0; j < layer.numNeurons; ++j)
+                sampleInputs[j] = sampleSums[j] * layer.outputScales[j] + layer.biases[j];
+        }
+
+        this->activate(batchSize * layer.numNeurons, netInputs, netInputs);
+    }
+}
+
+template<typename T>
+void BasicQuantizedNet<T>::setSigmoidMode(NeuralNetBase::SigmoidMode mode) {
+    this->sigmoidMode = mode;
+}
+
+template<typename T>
+NeuralNetBase::SigmoidMode BasicQuantizedNet<T>::getSigmoidMode() const {
+    return this->sigmoidMode;
+}
+
+template<typename T>
+size_t BasicQuantizedNet<T>::getNumLayers() const {
+    return this->layers.empty() ? 0 : this->layers.size() + 1;
+}
+
+template<typename T>
+size_t BasicQuantizedNet<T>::getNumInputs() const {
+    return this->layers.empty() ? 0 : this->layers.front().numInputs;
+}
+
+template<typename T>
+size_t BasicQuantizedNet<T>::getNumOutputs() const {
+    return this->layers.empty() ? 0 : this->layers.back().numNeurons;
+}
+
+template class BasicQuantizedNet<float>;
+template class BasicQuantizedNet<double>;
@@ -0,0 +1,146 @@
+/**
+* QuantizedNet
+*
+* A network with 8 bit integer weights for fast inference on the CPU. The weights of every neuron
+* are scaled to [-127, 127] with their own scale, the bias weights stay in floating point. Since
+* every layer receives sigmoid activations, its inputs are scaled to unsigned bytes [0, 255] with
+* a scale calibrated on sample inputs. The net inputs are accumulated in 32 bit integers (see
+* gemvInt8) and converted back to floating point for the sigmoid function.
+*
+* The quantized model is saved in its own binary file with the scales and the integer weights.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_QUANTIZED_NET_H
+#define _NEURAL_QUANTIZED_NET_H
+
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+#include "Dataset.h"
+#include "NeuralNet.h"
+
+using namespace std;
+
+template<typename T>
+class BasicQuantizedNet {
+public:
+    BasicQuantizedNet();
+    ~BasicQuantizedNet();
+
+    /**
+    * Quantizes the weights of the network. The input scale of every layer is calibrated with the
+    * largest activation of the layer before for numSamples sample inputs (row-major). Returns
+    * false without samples.
+    */
+    bool quantize(const BasicNeuralNet<T>& net, const T* inputs, size_t numSamples);
+
+    /**
+    * Quantizes the weights of the network and calibrates with the inputs of the dataset
+    */
+    bool quantize(const BasicNeuralNet<T>& net, const BasicDataset<T>& calibration);
+
+    /**
+    * Saves the quantized model
+    */
+    bool save(const string& filename) const;
+
+    /**
+    * Loads a model written by save()
+    */
+    bool load(const string& filename);
+
+    /**
+    * Calculates the outputs for one sample
+    */
+    void calculateOutputs(const T* inputs, T* outputs) const;
+
+    /**
+    * Calculates the outputs for one sample and returns them
+    */
+    vector<T> calculateOutputs(const vector<T>& inputs) const;
+
+    /**
+    * Calculates the outputs of batchSize samples (row-major inputs and outputs) with gemmInt8
+    */
+    void calculateOutputsBatch(const T* inputs, size_t batchSize, T* outputs) const;
+
+    /**
+    * Sets the evaluation of the sigmoid function, see NeuralNet::SigmoidMode
+    */
+    void setSigmoidMode(NeuralNetBase::SigmoidMode mode);
+    NeuralNetBase::SigmoidMode getSigmoidMode() const;
+
+    /**
+    * Returns the number of layers including the input and the output layer
+    */
+    size_t getNumLayers() const;
+
+    size_t getNumInputs() const;
+    size_t getNumOutputs() const;
+
+private:
+    BasicQuantizedNet(const BasicQuantizedNet&);
+    BasicQuantizedNet& operator=(const BasicQuantizedNet&);
+
+    struct QuantizedLayer {
+        size_t numNeurons;
+
+        /**
+        * Number of weights per neuron without the bias weight
+        */
+        size_t numInputs;
+
+        /**
+        * An input of the layer is inputScale * q with q in [0, 255]
+        */
+        T inputScale;
+
+        /**
+        * A weight of neuron i is weightScales[i] * q with q in [-127, 127]
+        */
+        vector<T> weightScales;
+
+        /**
+        * The bias weight of every neuron multiplied with the bias value (0 without bias)
+        */
+        vector<T> biases;
+
+        /**
+        * The quantized weight matrix (numNeurons x numInputs)
+        */
+        vector<int8_t> weights;
+
+        /**
+        * weightScales[i] * inputScale, converts the integer sums into net inputs
+        */
+        vector<T> outputScales;
+    };
+
+    /**
+    * Calculates the output scales and the size of the scratch buffers
+    */
+    void prepare();
+
+    /**
+    * Converts n activations into unsigned bytes with the input scale of the layer
+    */
+    void quantizeInputs(const QuantizedLayer& layer, size_t n, const T* activations, uint8_t* values) const;
+
+    /**
+    * Applies the sigmoid function to n net inputs
+    */
+    void activate(size_t n, const T* netInputs, T* activations) const;
+
+    // The layers after the input layer
+    vector<QuantizedLayer> layers;
+    size_t maxNeurons;
+    NeuralNetBase::SigmoidMode sigmoidMode;
+};
+
+typedef BasicQuantizedNet<double> QuantizedNet;
+
+#endif
@@ -0,0 +1,1161 @@
+/**
+* Simd
+*
+* The SIMD kernels and the runtime CPU dispatch.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "Simd.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NN_SIMD_X86
+#include <immintrin.h>
+#endif
+
+//
+// Scalar
+//
+
+template<typename T>
+static T dotScalar(size_t n, const T* x, const T* y) {
+    T sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sum0 += x[i] * y[i];
+        sum1 += x[i + 1] * y[i + 1];
+        sum2 += x[i + 2] * y[i + 2];
+        sum3 += x[i + 3] * y[i + 3];
+    }
+
+    for (; i < n; ++i)
+        sum0 += x[i] * y[i];
+
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+template<typename T>
+static void dot4Scalar(size_t n, const T* a0, const T* a1, const T* a2, const T* a3, const T* x, T* results) {
+    T sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+    for (size_t k = 0; k < n; ++k) {
+        T xk = x[k];
+        sum0 += a0[k] * xk;
+        sum1 += a1[k] * xk;
+        sum2 += a2[k] * xk;
+        sum3 += a3[k] * xk;
+    }
+
+    results[0] = sum0;
+    results[1] = sum1;
+    results[2] = sum2;
+    results[3] = sum3;
+}
+
+template<typename T>
+static void axpyScalar(size_t n, T alpha, const T* x, T* y) {
+    for (size_t i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+template<typename T>
+static void updateScalar(size_t n, T alpha, const T* x, T beta, T* d, T* w) {
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = alpha * x[i] + beta * d[i];
+        w[i] += d[i];
+    }
+}
+
+//
+// Constants of the fast sigmoid: exp(t) = 2^n * exp(r) with n = round(t / ln2), r = t - n * ln2
+//
+
+// Adding this constant rounds a double to an integer which ends up in the low mantissa bits
+static const double EXP_ROUND = 6755399441055744.0;
+static const double EXP_LOG2E = 1.4426950408889634;
+static const double EXP_LN2_HI = 6.93147180369123816490e-01;
+static const double EXP_LN2_LO = 1.90821492927058770002e-10;
+static const double EXP_LIMIT = 700;
+
+// Taylor coefficients of exp(r) up to degree 7
+static const double EXP_C2 = 1.0 / 2;
+static const double EXP_C3 = 1.0 / 6;
+static const double EXP_C4 = 1.0 / 24;
+static const double EXP_C5 = 1.0 / 120;
+static const double EXP_C6 = 1.0 / 720;
+static const double EXP_C7 = 1.0 / 5040;
+
+static void sigmoidScalar(size_t n, const double* x, double* y) {
+    int64_t roundBits;
+    memcpy(&roundBits, &EXP_ROUND, sizeof(roundBits));
+
+    for (size_t i = 0; i < n; ++i) {
+        double t = -x[i];
+        t = t < -EXP_LIMIT ? -EXP_LIMIT : (t > EXP_LIMIT ? EXP_LIMIT : t);
+
+        double k = t * EXP_LOG2E + EXP_ROUND;
+        double m = k - EXP_ROUND;
+        double r = t - m * EXP_LN2_HI - m * EXP_LN2_LO;
+
+        double p = EXP_C7;
+        p = p * r + EXP_C6;
+        p = p * r + EXP_C5;
+        p = p * r + EXP_C4;
+        p = p * r + EXP_C3;
+        p = p * r + EXP_C2;
+        p = p * r + 1;
+        p = p * r + 1;
+
+        int64_t bits;
+        memcpy(&bits, &k, sizeof(bits));
+        bits = (bits - roundBits + 1023) << 52;
+
+        double scale;
+        memcpy(&scale, &bits, sizeof(scale));
+
+        y[i] = 1 / (1 + p * scale);
+    }
+}
+
+// Single precision: exp(r) up to degree 6 is exact to the float resolution
+static const float EXPF_ROUND = 12582912.0f;
+static const float EXPF_LOG2E = 1.44269504f;
+static const float EXPF_LN2_HI = 6.93145752e-01f;
+static const float EXPF_LN2_LO = 1.42860677e-06f;
+static const float EXPF_LIMIT = 87;
+
+static void sigmoidScalar(size_t n, const float* x, float* y) {
+    int32_t roundBits;
+    memcpy(&roundBits, &EXPF_ROUND, sizeof(roundBits));
+
+    for (size_t i = 0; i < n; ++i) {
+        float t = -x[i];
+        t = t < -EXPF_LIMIT ? -EXPF_LIMIT : (t > EXPF_LIMIT ? EXPF_LIMIT : t);
+
+        float k = t * EXPF_LOG2E + EXPF_ROUND;
+        float m = k - EXPF_ROUND;
+        float r = t - m * EXPF_LN2_HI - m * EXPF_LN2_LO;
+
+        float p = (float) EXP_C6;
+        p = p * r + (float) EXP_C5;
+        p = p * r + (float) EXP_C4;
+        p = p * r + (float) EXP_C3;
+        p = p * r + (float) EXP_C2;
+        p = p * r + 1;
+        p = p * r + 1;
+
+        int32_t bits;
+        memcpy(&bits, &k, sizeof(bits));
+        bits = (bits - roundBits + 127) << 23;
+
+        float scale;
+        memcpy(&scale, &bits, sizeof(scale));
+
+        y[i] = 1 / (1 + p * scale);
+    }
+}
+
+template<typename T>
+static void interpolateScalar(size_t n, const T* table, size_t size, T first, T scale, const T* x, T* y) {
+    const T maxPosition = (T) (size - 1);
+
+    for (size_t i = 0; i < n; ++i) {
+        T position = (x[i] - first) * scale;
+
+        // NaN fails every comparison, it goes to the first value like in the max/min of the SIMD variants
+        position = !(position > 0) ? 0 : (position > maxPosition ? maxPosition : position);
+
+        int index = (int) position;
+        T fraction = position - index;
+        y[i] = table[index] + fraction * (table[index + 1] - table[index]);
+    }
+}
+
+#ifdef NN_SIMD_X86
+
+//
+// SSE2
+//
+
+__attribute__((target("sse2")))
+static double hsum(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+__attribute__((target("sse2")))
+static double dotSse2(size_t n, const double* x, const double* y) {
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+    }
+
+    double sum = hsum(_mm_add_pd(sum0, sum1));
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+__attribute__((target("sse2")))
+static void dot4Sse2(size_t n, const double* a0, const double* a1, const double* a2, const double* a3,
+                     const double* x, double* results) {
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd(), sum2 = _mm_setzero_pd(), sum3 = _mm_setzero_pd();
+
+    size_t k = 0;
+    for (; k + 2 <= n; k += 2) {
+        __m128d xk = _mm_loadu_pd(x + k);
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a0 + k), xk));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a1 + k), xk));
+        sum2 = _mm_add_pd(sum2, _mm_mul_pd(_mm_loadu_pd(a2 + k), xk));
+        sum3 = _mm_add_pd(sum3, _mm_mul_pd(_mm_loadu_pd(a3 + k), xk));
+    }
+
+    results[0] = hsum(sum0);
+    results[1] = hsum(sum1);
+    results[2] = hsum(sum2);
+    results[3] = hsum(sum3);
+
+    for (; k < n; ++k) {
+        results[0] += a0[k] * x[k];
+        results[1] += a1[k] * x[k];
+        results[2] += a2[k] * x[k];
+        results[3] += a3[k] * x[k];
+    }
+}
+
+__attribute__((target("sse2")))
+static void axpySse2(size_t n, double alpha, const double* x, double* y) {
+    __m128d a = _mm_set1_pd(alpha);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("sse2")))
+static void updateSse2(size_t n, double alpha, const double* x, double beta, double* d, double* w) {
+    __m128d a = _mm_set1_pd(alpha), b = _mm_set1_pd(beta);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d di = _mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x + i)), _mm_mul_pd(b, _mm_loadu_pd(d + i)));
+        _mm_storeu_pd(d + i, di);
+        _mm_storeu_pd(w + i, _mm_add_pd(_mm_loadu_pd(w + i), di));
+    }
+
+    for (; i < n; ++i) {
+        d[i] = alpha * x[i] + beta * d[i];
+        w[i] += d[i];
+    }
+}
+
+__attribute__((target("sse2")))
+static void sigmoidSse2(size_t n, const double* x, double* y) {
+    const __m128d limit = _mm_set1_pd(EXP_LIMIT), round = _mm_set1_pd(EXP_ROUND), one = _mm_set1_pd(1);
+    const __m128i bias = _mm_sub_epi64(_mm_set1_epi64x(1023), _mm_castpd_si128(round));
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d t = _mm_sub_pd(_mm_setzero_pd(), _mm_loadu_pd(x + i));
+        t = _mm_min_pd(_mm_max_pd(t, _mm_sub_pd(_mm_setzero_pd(), limit)), limit);
+
+        __m128d k = _mm_add_pd(_mm_mul_pd(t, _mm_set1_pd(EXP_LOG2E)), round);
+        __m128d m = _mm_sub_pd(k, round);
+        __m128d r = _mm_sub_pd(_mm_sub_pd(t, _mm_mul_pd(m, _mm_set1_pd(EXP_LN2_HI))), _mm_mul_pd(m, _mm_set1_pd(EXP_LN2_LO)));
+
+        __m128d p = _mm_set1_pd(EXP_C7);
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C6));
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C5));
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C4));
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C3));
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C2));
+        p = _mm_add_pd(_mm_mul_pd(p, r), one);
+        p = _mm_add_pd(_mm_mul_pd(p, r), one);
+
+        __m128d scale = _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(k), bias), 52));
+        _mm_storeu_pd(y + i, _mm_div_pd(one, _mm_add_pd(one, _mm_mul_pd(p, scale))));
+    }
+
+    sigmoidScalar(n - i, x + i, y + i);
+}
+
+__attribute__((target("sse2")))
+static float hsum(__m128 v) {
+    __m128 sum = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+}
+
+__attribute__((target("sse2")))
+static float dotSse2(size_t n, const float* x, const float* y) {
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+    }
+
+    float sum = hsum(_mm_add_ps(sum0, sum1));
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+__attribute__((target("sse2")))
+static void dot4Sse2(size_t n, const float* a0, const float* a1, const float* a2, const float* a3,
+                     const float* x, float* results) {
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps(), sum2 = _mm_setzero_ps(), sum3 = _mm_setzero_ps();
+
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128 xk = _mm_loadu_ps(x + k);
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a0 + k), xk));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a1 + k), xk));
+        sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(a2 + k), xk));
+        sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(a3 + k), xk));
+    }
+
+    results[0] = hsum(sum0);
+    results[1] = hsum(sum1);
+    results[2] = hsum(sum2);
+    results[3] = hsum(sum3);
+
+    for (; k < n; ++k) {
+        results[0] += a0[k] * x[k];
+        results[1] += a1[k] * x[k];
+        results[2] += a2[k] * x[k];
+        results[3] += a3[k] * x[k];
+    }
+}
+
+__attribute__((target("sse2")))
+static void axpySse2(size_t n, float alpha, const float* x, float* y) {
+    __m128 a = _mm_set1_ps(alpha);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(a, _mm_loadu_ps(x + i))));
+
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("sse2")))
+static void updateSse2(size_t n, float alpha, const float* x, float beta, float* d, float* w) {
+    __m128 a = _mm_set1_ps(alpha), b = _mm_set1_ps(beta);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 di = _mm_add_ps(_mm_mul_ps(a, _mm_loadu_ps(x + i)), _mm_mul_ps(b, _mm_loadu_ps(d + i)));
+        _mm_storeu_ps(d + i, di);
+        _mm_storeu_ps(w + i, _mm_add_ps(_mm_loadu_ps(w + i), di));
+    }
+
+    for (; i < n; ++i) {
+        d[i] = alpha * x[i] + beta * d[i];
+        w[i] += d[i];
+    }
+}
+
+__attribute__((target("sse2")))
+static void sigmoidSse2(size_t n, const float* x, float* y) {
+    const __m128 limit = _mm_set1_ps(EXPF_LIMIT), round = _mm_set1_ps(EXPF_ROUND), one = _mm_set1_ps(1);
+    const __m128i bias = _mm_sub_epi32(_mm_set1_epi32(127), _mm_castps_si128(round));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 t = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(x + i));
+        t = _mm_min_ps(_mm_max_ps(t, _mm_sub_ps(_mm_setzero_ps(), limit)), limit);
+
+        __m128 k = _mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(EXPF_LOG2E)), round);
+        __m128 m = _mm_sub_ps(k, round);
+        __m128 r = _mm_sub_ps(_mm_sub_ps(t, _mm_mul_ps(m, _mm_set1_ps(EXPF_LN2_HI))), _mm_mul_ps(m, _mm_set1_ps(EXPF_LN2_LO)));
+
+        __m128 p = _mm_set1_ps((float) EXP_C6);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps((float) EXP_C5));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps((float) EXP_C4));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps((float) EXP_C3));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps((float) EXP_C2));
+        p = _mm_add_ps(_mm_mul_ps(p, r), one);
+        p = _mm_add_ps(_mm_mul_ps(p, r), one);
+
+        __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_castps_si128(k), bias), 23));
+        _mm_storeu_ps(y + i, _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(p, scale))));
+    }
+
+    sigmoidScalar(n - i, x + i, y + i);
+}
+
+//
+// AVX2 + FMA
+//
+
+__attribute__((target("avx2,fma")))
+static double hsum(__m256d v) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+__attribute__((target("avx2,fma")))
+static double dotAvx2(size_t n, const double* x, const double* y) {
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+    }
+
+    if (i + 4 <= n) {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+        i += 4;
+    }
+
+    double sum = hsum(_mm256_add_pd(sum0, sum1));
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static void dot4Avx2(size_t n, const double* a0, const double* a1, const double* a2, const double* a3,
+                     const double* x, double* results) {
+    __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+    __m256d sum2 = _mm256_setzero_pd(), sum3 = _mm256_setzero_pd();
+
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256d xk = _mm256_loadu_pd(x + k);
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a0 + k), xk, sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a1 + k), xk, sum1);
+        sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(a2 + k), xk, sum2);
+        sum3 = _mm256_fmadd_pd(_mm256_loadu_pd(a3 + k), xk, sum3);
+    }
+
+    results[0] = hsum(sum0);
+    results[1] = hsum(sum1);
+    results[2] = hsum(sum2);
+    results[3] = hsum(sum3);
+
+    for (; k < n; ++k) {
+        results[0] += a0[k] * x[k];
+        results[1] += a1[k] * x[k];
+        results[2] += a2[k] * x[k];
+        results[3] += a3[k] * x[k];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(size_t n, double alpha, const double* x, double* y) {
+    __m256d a = _mm256_set1_pd(alpha);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void updateAvx2(size_t n, double alpha, const double* x, double beta, double* d, double* w) {
+    __m256d a = _mm256_set1_pd(alpha), b = _mm256_set1_pd(beta);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d di = _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_mul_pd(b, _mm256_loadu_pd(d + i)));
+        _mm256_storeu_pd(d + i, di);
+        _mm256_storeu_pd(w + i, _mm256_add_pd(_mm256_loadu_pd(w + i), di));
+    }
+
+    for (; i < n; ++i) {
+        d[i] = alpha * x[i] + beta * d[i];
+        w[i] += d[i];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void sigmoidAvx2(size_t n, const double* x, double* y) {
+    const __m256d limit = _mm256_set1_pd(EXP_LIMIT), round = _mm256_set1_pd(EXP_ROUND), one = _mm256_set1_pd(1);
+    const __m256i bias = _mm256_sub_epi64(_mm256_set1_epi64x(1023), _mm256_castpd_si256(round));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d t = _mm256_sub_pd(_mm256_setzero_pd(), _mm256_loadu_pd(x + i));
+        t = _mm256_min_pd(_mm256_max_pd(t, _mm256_sub_pd(_mm256_setzero_pd(), limit)), limit);
+
+        __m256d k = _mm256_fmadd_pd(t, _mm256_set1_pd(EXP_LOG2E), round);
+        __m256d m = _mm256_sub_pd(k, round);
+        __m256d r = _mm256_fnmadd_pd(m, _mm256_set1_pd(EXP_LN2_HI), t);
+        r = _mm256_fnmadd_pd(m, _mm256_set1_pd(EXP_LN2_LO), r);
+
+        __m256d p = _mm256_set1_pd(EXP_C7);
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_C6));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_C5));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_C4));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_C3));
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_C2));
+        p = _mm256_fmadd_pd(p, r, one);
+        p = _mm256_fmadd_pd(p, r, one);
+
+        __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(k), bias), 52));
+        _mm256_storeu_pd(y + i, _mm256_div_pd(one, _mm256_fmadd_pd(p, scale, one)));
+    }
+
+    sigmoidScalar(n - i, x + i, y + i);
+}
+
+__attribute__((target("avx2,fma")))
+static void interpolateAvx2(size_t n, const double* table, size_t size, double first, double scale,
+                            const double* x, double* y) {
+    const __m256d maxPosition = _mm256_set1_pd((double) (size - 1));
+    const __m256d firstValue = _mm256_set1_pd(first), scaleValue = _mm256_set1_pd(scale);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d position = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), firstValue), scaleValue);
+        position = _mm256_min_pd(_mm256_max_pd(position, _mm256_setzero_pd()), maxPosition);
+
+        __m128i index = _mm256_cvttpd_epi32(position);
+        __m256d fraction = _mm256_sub_pd(position, _mm256_cvtepi32_pd(index));
+        __m256d lower = _mm256_i32gather_pd(table, index, 8);
+        __m256d upper = _mm256_i32gather_pd(table + 1, index, 8);
+
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(fraction, _mm256_sub_pd(upper, lower), lower));
+    }
+
+    interpolateScalar(n - i, table, size, first, scale, x + i, y + i);
+}
+
+__attribute__((target("avx2,fma")))
+static float hsum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+}
+
+__attribute__((target("avx2,fma")))
+static float dotAvx2(size_t n, const float* x, const float* y) {
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+    }
+
+    if (i + 8 <= n) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+        i += 8;
+    }
+
+    float sum = hsum(_mm256_add_ps(sum0, sum1));
+    for (; i < n; ++i)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static void dot4Avx2(size_t n, const float* a0, const float* a1, const float* a2, const float* a3,
+                     const float* x, float* results) {
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps(), sum3 = _mm256_setzero_ps();
+
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 xk = _mm256_loadu_ps(x + k);
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a0 + k), xk, sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a1 + k), xk, sum1);
+        sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(a2 + k), xk, sum2);
+        sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(a3 + k), xk, sum3);
+    }
+
+    results[0] = hsum(sum0);
+    results[1] = hsum(sum1);
+    results[2] = hsum(sum2);
+    results[3] = hsum(sum3);
+
+    for (; k < n; ++k) {
+        results[0] += a0[k] * x[k];
+        results[1] += a1[k] * x[k];
+        results[2] += a2[k] * x[k];
+        results[3] += a3[k] * x[k];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(size_t n, float alpha, const float* x, float* y) {
+    __m256 a = _mm256_set1_ps(alpha);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+
+    for (; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void updateAvx2(size_t n, float alpha, const float* x, float beta, float* d, float* w) {
+    __m256 a = _mm256_set1_ps(alpha), b = _mm256_set1_ps(beta);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 di = _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_mul_ps(b, _mm256_loadu_ps(d + i)));
+        _mm256_storeu_ps(d + i, di);
+        _mm256_storeu_ps(w + i, _mm256_add_ps(_mm256_loadu_ps(w + i), di));
+    }
+
+    for (; i < n; ++i) {
+        d[i] = alpha * x[i] + beta * d[i];
+        w[i] += d[i];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static void sigmoidAvx2(size_t n, const float* x, float* y) {
+    const __m256 limit = _mm256_set1_ps(EXPF_LIMIT), round = _mm256_set1_ps(EXPF_ROUND), one = _mm256_set1_ps(1);
+    const __m256i bias = _mm256_sub_epi32(_mm256_set1_epi32(127), _mm256_castps_si256(round));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(x + i));
+        t = _mm256_min_ps(_mm256_max_ps(t, _mm256_sub_ps(_mm256_setzero_ps(), limit)), limit);
+
+        __m256 k = _mm256_fmadd_ps(t, _mm256_set1_ps(EXPF_LOG2E), round);
+        __m256 m = _mm256_sub_ps(k, round);
+        __m256 r = _mm256_fnmadd_ps(m, _mm256_set1_ps(EXPF_LN2_HI), t);
+        r = _mm256_fnmadd_ps(m, _mm256_set1_ps(EXPF_LN2_LO), r);
+
+        __m256 p = _mm256_set1_ps((float) EXP_C6);
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps((float) EXP_C5));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps((float) EXP_C4));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps((float) EXP_C3));
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps((float) EXP_C2));
+        p = _mm256_fmadd_ps(p, r, one);
+        p = _mm256_fmadd_ps(p, r, one);
+
+        __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_castps_si256(k), bias), 23));
+        _mm256_storeu_ps(y + i, _mm256_div_ps(one, _mm256_fmadd_ps(p, scale, one)));
+    }
+
+    sigmoidScalar(n - i, x + i, y + i);
+}
+
+__attribute__((target("avx2,fma")))
+static void interpolateAvx2(size_t n, const float* table, size_t size, float first, float scale,
+                            const float* x, float* y) {
+    const __m256 maxPosition = _mm256_set1_ps((float) (size - 1));
+    const __m256 firstValue = _mm256_set1_ps(first), scaleValue = _mm256_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 position = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), firstValue), scaleValue);
+        position = _mm256_min_ps(_mm256_max_ps(position, _mm256_setzero_ps()), maxPosition);
+
+        __m256i index = _mm256_cvttps_epi32(position);
+        __m256 fraction = _mm256_sub_ps(position, _mm256_cvtepi32_ps(index));
+        __m256 lower = _mm256_i32gather_ps(table, index, 4);
+        __m256 upper = _mm256_i32gather_ps(table + 1, index, 4);
+
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(fraction, _mm256_sub_ps(upper, lower), lower));
+    }
+
+    interpolateScalar(n - i, table, size, first, scale, x + i, y + i);
+}
+
+//
+// AVX-512
+//
+
+__attribute__((target("avx512f")))
+static double dotAvx512(size_t n, const double* x, const double* y) {
+    __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), sum1);
+    }
+
+    for (; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (__mmask8) ((1u << (n - i)) - 1);
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), sum0);
+    }
+
+    return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+}
+
+__attribute__((target("avx512f")))
+static void dot4Avx512(size_t n, const double* a0, const double* a1, const double* a2, const double* a3,
+                       const double* x, double* results) {
+    __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd();
+    __m512d sum2 = _mm512_setzero_pd(), sum3 = _mm512_setzero_pd();
+
+    for (size_t k = 0; k < n; k += 8) {
+        __mmask8 mask = n - k >= 8 ? 0xFF : (__mmask8) ((1u << (n - k)) - 1);
+        __m512d xk = _mm512_maskz_loadu_pd(mask, x + k);
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a0 + k), xk, sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a1 + k), xk, sum1);
+        sum2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a2 + k), xk, sum2);
+        sum3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a3 + k), xk, sum3);
+    }
+
+    results[0] = _mm512_reduce_add_pd(sum0);
+    results[1] = _mm512_reduce_add_pd(sum1);
+    results[2] = _mm512_reduce_add_pd(sum2);
+    results[3] = _mm512_reduce_add_pd(sum3);
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(size_t n, double alpha, const double* x, double* y) {
+    __m512d a = _mm512_set1_pd(alpha);
+
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (__mmask8) ((1u << (n - i)) - 1);
+        __m512d yi = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+        _mm512_mask_storeu_pd(y + i, mask, yi);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void updateAvx512(size_t n, double alpha, const double* x, double beta, double* d, double* w) {
+    __m512d a = _mm512_set1_pd(alpha), b = _mm512_set1_pd(beta);
+
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (__mmask8) ((1u << (n - i)) - 1);
+        __m512d di = _mm512_mul_pd(b, _mm512_maskz_loadu_pd(mask, d + i));
+        di = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, x + i), di);
+        _mm512_mask_storeu_pd(d + i, mask, di);
+        _mm512_mask_storeu_pd(w + i, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, w + i), di));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void sigmoidAvx512(size_t n, const double* x, double* y) {
+    const __m512d limit = _mm512_set1_pd(EXP_LIMIT), round = _mm512_set1_pd(EXP_ROUND), one = _mm512_set1_pd(1);
+    const __m512i bias = _mm512_sub_epi64(_mm512_set1_epi64(1023), _mm512_castpd_si512(round));
+
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (__mmask8) ((1u << (n - i)) - 1);
+
+        __m512d t = _mm512_sub_pd(_mm512_setzero_pd(), _mm512_maskz_loadu_pd(mask, x + i));
+        t = _mm512_min_pd(_mm512_max_pd(t, _mm512_sub_pd(_mm512_setzero_pd(), limit)), limit);
+
+        __m512d k = _mm512_fmadd_pd(t, _mm512_set1_pd(EXP_LOG2E), round);
+        __m512d m = _mm512_sub_pd(k, round);
+        __m512d r = _mm512_fnmadd_pd(m, _mm512_set1_pd(EXP_LN2_HI), t);
+        r = _mm512_fnmadd_pd(m, _mm512_set1_pd(EXP_LN2_LO), r);
+
+        __m512d p = _mm512_set1_pd(EXP_C7);
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_C6));
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_C5));
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_C4));
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_C3));
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_C2));
+        p = _mm512_fmadd_pd(p, r, one);
+        p = _mm512_fmadd_pd(p, r, one);
+
+        __m512d scale = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(_mm512_castpd_si512(k), bias), 52));
+        _mm512_mask_storeu_pd(y + i, mask, _mm512_div_pd(one, _mm512_fmadd_pd(p, scale, one)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void interpolateAvx512(size_t n, const double* table, size_t size, double first, double scale,
+                              const double* x, double* y) {
+    const __m512d maxPosition = _mm512_set1_pd((double) (size - 1));
+    const __m512d firstValue = _mm512_set1_pd(first), scaleValue = _mm512_set1_pd(scale);
+
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 mask = n - i >= 8 ? 0xFF : (__mmask8) ((1u << (n - i)) - 1);
+
+        __m512d position = _mm512_mul_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), firstValue), scaleValue);
+        position = _mm512_min_pd(_mm512_max_pd(position, _mm512_setzero_pd()), maxPosition);
+
+        __m256i index = _mm512_cvttpd_epi32(position);
+        __m512d fraction = _mm512_sub_pd(position, _mm512_cvtepi32_pd(index));
+        __m512d lower = _mm512_i32gather_pd(index, table, 8);
+        __m512d upper = _mm512_i32gather_pd(index, table + 1, 8);
+
+        _mm512_mask_storeu_pd(y + i, mask, _mm512_fmadd_pd(fraction, _mm512_sub_pd(upper, lower), lower));
+    }
+}
+
+__attribute__((target("avx512f")))
+static float dotAvx512(size_t n, const float* x, const float* y) {
+    __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), sum1);
+    }
+
+    for (; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - i)) - 1);
+        sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i), sum0);
+    }
+
+    return _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f")))
+static void dot4Avx512(size_t n, const float* a0, const float* a1, const float* a2, const float* a3,
+                       const float* x, float* results) {
+    __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+    __m512 sum2 = _mm512_setzero_ps(), sum3 = _mm512_setzero_ps();
+
+    for (size_t k = 0; k < n; k += 16) {
+        __mmask16 mask = n - k >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - k)) - 1);
+        __m512 xk = _mm512_maskz_loadu_ps(mask, x + k);
+        sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a0 + k), xk, sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a1 + k), xk, sum1);
+        sum2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a2 + k), xk, sum2);
+        sum3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a3 + k), xk, sum3);
+    }
+
+    results[0] = _mm512_reduce_add_ps(sum0);
+    results[1] = _mm512_reduce_add_ps(sum1);
+    results[2] = _mm512_reduce_add_ps(sum2);
+    results[3] = _mm512_reduce_add_ps(sum3);
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(size_t n, float alpha, const float* x, float* y) {
+    __m512 a = _mm512_set1_ps(alpha);
+
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - i)) - 1);
+        __m512 yi = _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+        _mm512_mask_storeu_ps(y + i, mask, yi);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void updateAvx512(size_t n, float alpha, const float* x, float beta, float* d, float* w) {
+    __m512 a = _mm512_set1_ps(alpha), b = _mm512_set1_ps(beta);
+
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - i)) - 1);
+        __m512 di = _mm512_mul_ps(b, _mm512_maskz_loadu_ps(mask, d + i));
+        di = _mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(mask, x + i), di);
+        _mm512_mask_storeu_ps(d + i, mask, di);
+        _mm512_mask_storeu_ps(w + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, w + i), di));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void sigmoidAvx512(size_t n, const float* x, float* y) {
+    const __m512 limit = _mm512_set1_ps(EXPF_LIMIT), round = _mm512_set1_ps(EXPF_ROUND), one = _mm512_set1_ps(1);
+    const __m512i bias = _mm512_sub_epi32(_mm512_set1_epi32(127), _mm512_castps_si512(round));
+
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - i)) - 1);
+
+        __m512 t = _mm512_sub_ps(_mm512_setzero_ps(), _mm512_maskz_loadu_ps(mask, x + i));
+        t = _mm512_min_ps(_mm512_max_ps(t, _mm512_sub_ps(_mm512_setzero_ps(), limit)), limit);
+
+        __m512 k = _mm512_fmadd_ps(t, _mm512_set1_ps(EXPF_LOG2E), round);
+        __m512 m = _mm512_sub_ps(k, round);
+        __m512 r = _mm512_fnmadd_ps(m, _mm512_set1_ps(EXPF_LN2_HI), t);
+        r = _mm512_fnmadd_ps(m, _mm512_set1_ps(EXPF_LN2_LO), r);
+
+        __m512 p = _mm512_set1_ps((float) EXP_C6);
+        p = _mm512_fmadd_ps(p, r, _mm512_set1_ps((float) EXP_C5));
+        p = _mm512_fmadd_ps(p, r, _mm512_set1_ps((float) EXP_C4));
+        p = _mm512_fmadd_ps(p, r, _mm512_set1_ps((float) EXP_C3));
+        p = _mm512_fmadd_ps(p, r, _mm512_set1_ps((float) EXP_C2));
+        p = _mm512_fmadd_ps(p, r, one);
+        p = _mm512_fmadd_ps(p, r, one);
+
+        __m512 scale = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_castps_si512(k), bias), 23));
+        _mm512_mask_storeu_ps(y + i, mask, _mm512_div_ps(one, _mm512_fmadd_ps(p, scale, one)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void interpolateAvx512(size_t n, const float* table, size_t size, float first, float scale,
+                              const float* x, float* y) {
+    const __m512 maxPosition = _mm512_set1_ps((float) (size - 1));
+    const __m512 firstValue = _mm512_set1_ps(first), scaleValue = _mm512_set1_ps(scale);
+
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 mask = n - i >= 16 ? 0xFFFF : (__mmask16) ((1u << (n - i)) - 1);
+
+        __m512 position = _mm512_mul_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + i), firstValue), scaleValue);
+        position = _mm512_min_ps(_mm512_max_ps(position, _mm512_setzero_ps()), maxPosition);
+
+        __m512i index = _mm512_cvttps_epi32(position);
+        __m512 fraction = _mm512_sub_ps(position, _mm512_cvtepi32_ps(index));
+        __m512 lower = _mm512_i32gather_ps(index, table, 4);
+        __m512 upper = _mm512_i32gather_ps(index, table + 1, 4);
+
+        _mm512_mask_storeu_ps(y + i, mask, _mm512_fmadd_ps(fraction, _mm512_sub_ps(upper, lower), lower));
+    }
+}
+
+#endif
+
+//
+// 8 bit integers
+//
+
+static int32_t dotInt8Scalar(size_t n, const int8_t* a, const uint8_t* x) {
+    int32_t sum = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        sum += a[i] * x[i];
+
+    return sum;
+}
+
+static void dot4Int8Scalar(size_t n, const int8_t* a0, const int8_t* a1, const int8_t* a2, const int8_t* a3,
+                           const uint8_t* x, int32_t* results) {
+    int32_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+    for (size_t k = 0; k < n; ++k) {
+        int32_t xk = x[k];
+        sum0 += a0[k] * xk;
+        sum1 += a1[k] * xk;
+        sum2 += a2[k] * xk;
+        sum3 += a3[k] * xk;
+    }
+
+    results[0] = sum0;
+    results[1] = sum1;
+    results[2] = sum2;
+    results[3] = sum3;
+}
+
+#ifdef NN_SIMD_X86
+
+// The AVX2 and AVX-512BW variants widen both operands to 16 bits, the pairwise products of
+// madd_epi16 (at most 2 * 255 * 127) can not overflow
+
+__attribute__((target("avx2,fma")))
+static int32_t hsum(__m256i v) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2,fma")))
+static int32_t dotInt8Avx2(size_t n, const int8_t* a, const uint8_t* x) {
+    __m256i sum = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i xv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        __m256i av = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(av, xv));
+    }
+
+    return hsum(sum) + dotInt8Scalar(n - i, a + i, x + i);
+}
+
+__attribute__((target("avx2,fma")))
+static void dot4Int8Avx2(size_t n, const int8_t* a0, const int8_t* a1, const int8_t* a2, const int8_t* a3,
+                         const uint8_t* x, int32_t* results) {
+    __m256i sum0 = _mm256_setzero_si256(), sum1 = _mm256_setzero_si256();
+    __m256i sum2 = _mm256_setzero_si256(), sum3 = _mm256_setzero_si256();
+
+    size_t k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i xv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k)));
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a0 + k))), xv));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a1 + k))), xv));
+        sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a2 + k))), xv));
+        sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a3 + k))), xv));
+    }
+
+    int32_t tail[4];
+    dot4Int8Scalar(n - k, a0 + k, a1 + k, a2 + k, a3 + k, x + k, tail);
+
+    results[0] = hsum(sum0) + tail[0];
+    results[1] = hsum(sum1) + tail[1];
+    results[2] = hsum(sum2) + tail[2];
+    results[3] = hsum(sum3) + tail[3];
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vl")))
+static int32_t dotInt8Avx512(size_t n, const int8_t* a, const uint8_t* x) {
+    __m512i sum = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < n; i += 32) {
+        __mmask32 mask = n - i >= 32 ? 0xFFFFFFFF : (__mmask32) ((1u << (n - i)) - 1);
+        __m512i xv = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, x + i));
+        __m512i av = _mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, a + i));
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(av, xv));
+    }
+
+    return _mm512_reduce_add_epi32(sum);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vl")))
+static void dot4Int8Avx512(size_t n, const int8_t* a0, const int8_t* a1, const int8_t* a2, const int8_t* a3,
+                           const uint8_t* x, int32_t* results) {
+    __m512i sum0 = _mm512_setzero_si512(), sum1 = _mm512_setzero_si512();
+    __m512i sum2 = _mm512_setzero_si512(), sum3 = _mm512_setzero_si512();
+
+    for (size_t k = 0; k < n; k += 32) {
+        __mmask32 mask = n - k >= 32 ? 0xFFFFFFFF : (__mmask32) ((1u << (n - k)) - 1);
+        __m512i xv = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(mask, x + k));
+        sum0 = _mm512_add_epi32(sum0, _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, a0 + k)), xv));
+        sum1 = _mm512_add_epi32(sum1, _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, a1 + k)), xv));
+        sum2 = _mm512_add_epi32(sum2, _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, a2 + k)), xv));
+        sum3 = _mm512_add_epi32(sum3, _mm512_madd_epi16(_mm512_cvtepi8_epi16(_mm256_maskz_loadu_epi8(mask, a3 + k)), xv));
+    }
+
+    results[0] = _mm512_reduce_add_epi32(sum0);
+    results[1] = _mm512_reduce_add_epi32(sum1);
+    results[2] = _mm512_reduce_add_epi32(sum2);
+    results[3] = _mm512_reduce_add_epi32(sum3);
+}
+
+// VNNI multiplies unsigned by signed bytes and adds four neighbouring products to a 32 bit lane
+// in one instruction (vpdpbusd), 64 products per instruction
+
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static int32_t dotInt8Vnni(size_t n, const int8_t* a, const uint8_t* x) {
+    __m512i sum = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < n; i += 64) {
+        __mmask64 mask = n - i >= 64 ? ~0ull : (1ull << (n - i)) - 1;
+        sum = _mm512_dpbusd_epi32(sum, _mm512_maskz_loadu_epi8(mask, x + i), _mm512_maskz_loadu_epi8(mask, a + i));
+    }
+
+    return _mm512_reduce_add_epi32(sum);
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static void dot4Int8Vnni(size_t n, const int8_t* a0, const int8_t* a1, const int8_t* a2, const int8_t* a3,
+                         const uint8_t* x, int32_t* results) {
+    __m512i sum0 = _mm512_setzero_si512(), sum1 = _mm512_setzero_si512();
+    __m512i sum2 = _mm512_setzero_si512(), sum3 = _mm512_setzero_si512();
+
+    for (size_t k = 0; k < n; k += 64) {
+        __mmask64 mask = n - k >= 64 ? ~0ull : (1ull << (n - k)) - 1;
+        __m512i xv = _mm512_maskz_loadu_epi8(mask, x + k);
+        sum0 = _mm512_dpbusd_epi32(sum0, xv, _mm512_maskz_loadu_epi8(mask, a0 + k));
+        sum1 = _mm512_dpbusd_epi32(sum1, xv, _mm512_maskz_loadu_epi8(mask, a1 + k));
+        sum2 = _mm512_dpbusd_epi32(sum2, xv, _mm512_maskz_loadu_epi8(mask, a2 + k));
+        sum3 = _mm512_dpbusd_epi32(sum3, xv, _mm512_maskz_loadu_epi8(mask, a3 + k));
+    }
+
+    results[0] = _mm512_reduce_add_epi32(sum0);
+    results[1] = _mm512_reduce_add_epi32(sum1);
+    results[2] = _mm512_reduce_add_epi32(sum2);
+    results[3] = _mm512_reduce_add_epi32(sum3);
+}
+
+#endif
+
+//
+// Dispatch
+//
+
+/**
+* Returns the highest instruction set level (0 = scalar, 1 = SSE2, 2 = AVX2, 3 = AVX-512) which is
+* supported by the CPU and allowed by NN_SIMD
+*/
+static int selectLevel() {
+#ifdef NN_SIMD_X86
+    // NN_SIMD limits the instruction set, e.g. to compare the variants on one machine
+    const char* limit = getenv("NN_SIMD");
+    int maxLevel = 3;
+    if (limit != 0) {
+        if (strcmp(limit, "scalar") == 0)
+            maxLevel = 0;
+        else if (strcmp(limit, "sse2") == 0)
+            maxLevel = 1;
+        else if (strcmp(limit, "avx2") == 0)
+            maxLevel = 2;
+    }
+
+    __builtin_cpu_init();
+
+    if (maxLevel >= 3 && __builtin_cpu_supports("avx512f"))
+        return 3;
+    if (maxLevel >= 2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return 2;
+    if (maxLevel >= 1 && __builtin_cpu_supports("sse2"))
+        return 1;
+#endif
+
+    return 0;
+}
+
+template<typename T>
+static SimdKernels<T> selectKernels() {
+    const SimdKernels<T> scalar = { "scalar", dotScalar<T>, dot4Scalar<T>, axpyScalar<T>, updateScalar<T>, sigmoidScalar, interpolateScalar<T> };
+
+#ifdef NN_SIMD_X86
+    const SimdKernels<T> sse2 = { "sse2", dotSse2, dot4Sse2, axpySse2, updateSse2, sigmoidSse2, interpolateScalar<T> };
+    const SimdKernels<T> avx2 = { "avx2", dotAvx2, dot4Avx2, axpyAvx2, updateAvx2, sigmoidAvx2, interpolateAvx2 };
+    const SimdKernels<T> avx512 = { "avx512", dotAvx512, dot4Avx512, axpyAvx512, updateAvx512, sigmoidAvx512, interpolateAvx512 };
+
+    switch (selectLevel()) {
+        case 3: return avx512;
+        case 2: return avx2;
+        case 1: return sse2;
+    }
+#endif
+
+    return scalar;
+}
+
+template<>
+const SimdKernels<float>& simdKernels<float>() {
+    static const SimdKernels<float> kernels = selectKernels<float>();
+    return kernels;
+}
+
+template<>
+const SimdKernels<double>& simdKernels<double>() {
+    static const SimdKernels<double> kernels = selectKernels<double>();
+    return kernels;
+}
+
+static SimdInt8Kernels selectInt8Kernels() {
+    const SimdInt8Kernels scalar = { "scalar", dotInt8Scalar, dot4Int8Scalar };
+
+#ifdef NN_SIMD_X86
+    const SimdInt8Kernels avx2 = { "avx2", dotInt8Avx2, dot4Int8Avx2 };
+    const SimdInt8Kernels avx512 = { "avx512", dotInt8Avx512, dot4Int8Avx512 };
+    const SimdInt8Kernels vnni = { "avx512vnni", dotInt8Vnni, dot4Int8Vnni };
+
+    // Below AVX2 the scalar kernels are used
+    int level = selectLevel();
+
+    if (level >= 3 && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vnni"))
+        return vnni;
+    if (level >= 3 && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+        return avx512;
+    if (level >= 2)
+        return avx2;
+#endif
+
+    return scalar;
+}
+
+const SimdInt8Kernels& simdInt8Kernels() {
+    static const SimdInt8Kernels kernels = selectInt8Kernels();
+    return kernels;
+}
@@ -0,0 +1,102 @@
+/**
+* Simd
+*
+* SIMD implementations of the innermost kernels (scalar, SSE2, AVX2 and AVX-512) for float and
+* double. The best variant supported by the CPU is selected once at startup, so the same binary runs
+* on every x86 machine. The environment variable NN_SIMD (scalar, sse2, avx2 or avx512) restricts
+* the selection.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_SIMD_H
+#define _NEURAL_SIMD_H
+
+#include <cstddef>
+#include <stdint.h>
+
+using namespace std;
+
+template<typename T>
+struct SimdKernels {
+    /**
+    * Name of the instruction set
+    */
+    const char* name;
+
+    /**
+    * Returns the dot product of x and y
+    */
+    T (*dot)(size_t n, const T* x, const T* y);
+
+    /**
+    * Calculates the dot products of the four rows a0..a3 with x
+    */
+    void (*dot4)(size_t n, const T* a0, const T* a1, const T* a2, const T* a3, const T* x, T* results);
+
+    /**
+    * y = alpha * x + y
+    */
+    void (*axpy)(size_t n, T alpha, const T* x, T* y);
+
+    /**
+    * d = alpha * x + beta * d, w += d in one pass
+    */
+    void (*update)(size_t n, T alpha, const T* x, T beta, T* d, T* w);
+
+    /**
+    * y = 1 / (1 + exp(-x)) with exp approximated by a range reduction to [-ln2/2, ln2/2] and a
+    * polynomial (degree 7 for double, degree 6 for float). The maximum absolute error is 2e-9 for
+    * double and 2e-7 for float (x and y may be the same buffer).
+    */
+    void (*sigmoid)(size_t n, const T* x, T* y);
+
+    /**
+    * Linear interpolation in a table of size values sampled from first with a distance of
+    * 1 / scale. x is clamped to the table range (NaN to the first value), the table must hold one
+    * additional copy of the last value (x and y may be the same buffer).
+    */
+    void (*interpolate)(size_t n, const T* table, size_t size, T first, T scale, const T* x, T* y);
+};
+
+/**
+* The kernels of the quantized inference: unsigned 8 bit activations times signed 8 bit weights,
+* accumulated in 32 bit integers
+*/
+struct SimdInt8Kernels {
+    /**
+    * Name of the instruction set
+    */
+    const char* name;
+
+    /**
+    * Returns the dot product of the weights a and the activations x
+    */
+    int32_t (*dot)(size_t n, const int8_t* a, const uint8_t* x);
+
+    /**
+    * Calculates the dot products of the four weight rows a0..a3 with the activations x
+    */
+    void (*dot4)(size_t n, const int8_t* a0, const int8_t* a1, const int8_t* a2, const int8_t* a3, const uint8_t* x,
+                 int32_t* results);
+};
+
+/**
+* Returns the kernels selected for this CPU
+*/
+template<typename T>
+const SimdKernels<T>& simdKernels();
+
+template<>
+const SimdKernels<float>& simdKernels<float>();
+
+template<>
+const SimdKernels<double>& simdKernels<double>();
+
+/**
+* Returns the 8 bit integer kernels selected for this CPU (AVX-512 VNNI, AVX-512BW, AVX2 or scalar)
+*/
+const SimdInt8Kernels& simdInt8Kernels();
+
+#endif
@@ -0,0 +1,143 @@
+/**
+* ThreadPool
+*
+* The implementation of the work-stealing thread pool.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads)
+    : numThreads(numThreads > 0 ? numThreads : max(thread::hardware_concurrency(), 1u)),
+      body(0),
+      numPending(0),
+      generation(0),
+      stopped(false)
+{
+    for (size_t worker = 0; worker < this->numThreads; ++worker)
+        this->queues.push_back(unique_ptr<Queue>(new Queue()));
+
+    // The calling thread is the first worker
+    for (size_t worker = 1; worker < this->numThreads; ++worker)
+        this->threads.push_back(thread(&ThreadPool::run, this, worker));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopped = true;
+    }
+
+    this->wakeUp.notify_all();
+
+    for (thread& worker : this->threads)
+        worker.join();
+}
+
+size_t ThreadPool::getNumThreads() const {
+    return this->numThreads;
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grainSize, const function<void(size_t, size_t)>& body) {
+    if (begin >= end)
+        return;
+
+    grainSize = max(grainSize, size_t(1));
+
+    // Without helpers or with a single chunk the range is processed right away
+    if (this->numThreads == 1 || end - begin <= grainSize) {
+        body(begin, end);
+        return;
+    }
+
+    this->body = &body;
+    this->numPending = (end - begin + grainSize - 1) / grainSize;
+
+    // Distribute the chunks in contiguous blocks, so every thread works on neighbouring indices
+    size_t numChunks = this->numPending;
+    size_t chunk = 0;
+
+    for (size_t first = begin; first < end; first += grainSize, ++chunk) {
+        Queue& queue = *this->queues[chunk * this->numThreads / numChunks];
+        lock_guard<mutex> guard(queue.lock);
+        queue.chunks.push_back(make_pair(first, min(first + grainSize, end)));
+    }
+
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->generation++;
+    }
+
+    this->wakeUp.notify_all();
+
+    while (this->processChunk(0)) {
+    }
+
+    // Wait for the chunks which are still processed by other threads
+    unique_lock<mutex> guard(this->lock);
+    while (this->numPending > 0)
+        this->finished.wait(guard);
+
+    this->body = 0;
+}
+
+void ThreadPool::run(size_t worker) {
+    size_t generation = 0;
+
+    while (true) {
+        {
+            unique_lock<mutex> guard(this->lock);
+            while (!this->stopped && generation == this->generation)
+                this->wakeUp.wait(guard);
+
+            if (this->stopped)
+                return;
+
+            generation = this->generation;
+        }
+
+        while (this->processChunk(worker)) {
+        }
+    }
+}
+
+bool ThreadPool::processChunk(size_t worker) {
+    pair<size_t, size_t> range;
+    bool found = false;
+
+    // The own queue first (front), then steal from the others (back)
+    for (size_t i = 0; i < this->numThreads && !found; ++i) {
+        Queue& queue = *this->queues[(worker + i) % this->numThreads];
+        lock_guard<mutex> guard(queue.lock);
+
+        if (queue.chunks.empty())
+            continue;
+
+        if (i == 0) {
+            range = queue.chunks.front();
+            queue.chunks.pop_front();
+        } else {
+            range = queue.chunks.back();
+            queue.chunks.pop_back();
+        }
+
+        found = true;
+    }
+
+    if (!found)
+        return false;
+
+    (*this->body)(range.first, range.second);
+
+    // The last chunk wakes up the caller of parallelFor
+    if (--this->numPending == 0) {
+        lock_guard<mutex> guard(this->lock);
+        this->finished.notify_all();
+    }
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+* ThreadPool
+*
+* A pool of worker threads with work stealing. parallelFor() splits an index range into chunks
+* which are distributed over one queue per thread. Every thread works on the front of its own
+* queue and steals from the back of the other queues once its queue is empty, so uneven chunks
+* are balanced automatically. The calling thread takes part as the first worker.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_THREAD_POOL_H
+#define _NEURAL_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool {
+public:
+    /**
+    * Creates a pool with numThreads threads (including the caller), 0 uses all cores
+    */
+    ThreadPool(size_t numThreads = 0);
+    ~ThreadPool();
+
+    /**
+    * Calls body(first, last) for chunks of at most grainSize indices which cover [begin, end) and
+    * returns once all chunks are processed. Only one parallelFor may run at a time.
+    */
+    void parallelFor(size_t begin, size_t end, size_t grainSize, const function<void(size_t, size_t)>& body);
+
+    /**
+    * Returns the number of threads (including the caller)
+    */
+    size_t getNumThreads() const;
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    /**
+    * The chunks of one thread
+    */
+    struct Queue {
+        mutex lock;
+        deque<pair<size_t, size_t>> chunks;
+    };
+
+    /**
+    * The loop of the background workers: wait for a parallelFor and help processing it
+    */
+    void run(size_t worker);
+
+    /**
+    * Takes a chunk from the own queue or steals one from another queue and processes it.
+    * Returns false if all queues are empty.
+    */
+    bool processChunk(size_t worker);
+
+    size_t numThreads;
+    vector<thread> threads;
+    vector<unique_ptr<Queue>> queues;
+
+    mutex lock;
+    condition_variable wakeUp;
+    condition_variable finished;
+
+    const function<void(size_t, size_t)>* body;
+    atomic<size_t> numPending;
+    size_t generation;
+    bool stopped;
+};
+
+#endif
@@ -78,3 +78,13 @@ int binVecToInt(vector<double> binVec) {
     }
     return sum;
 }
+
+template<>
+const char* scalarTypeName<float>() {
+    return "float";
+}
+
+template<>
+const char* scalarTypeName<double>() {
+    return "double";
+}
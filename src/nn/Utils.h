@@ -47,4 +47,16 @@ double roundDouble(double number, int digits);
 
 int binVecToInt(vector<double> binVec);
 
+/**
+* Returns the name of the scalar type T ("float" or "double")
+*/
+template<typename T>
+const char* scalarTypeName();
+
+template<>
+const char* scalarTypeName<float>();
+
+template<>
+const char* scalarTypeName<double>();
+
 #endif
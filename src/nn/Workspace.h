@@ -0,0 +1,54 @@
+/**
+* Workspace
+*
+* The scratch memory of a batched forward and backward pass: the activations and error values of
+* every layer for every sample of a batch and the accumulated weight gradients. The weights are not
+* part of the workspace, so several workspaces (e.g. one per thread) can work on the same network.
+* Only the asynchronous training keeps a private copy of the weights in it.
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#ifndef _NEURAL_WORKSPACE_H
+#define _NEURAL_WORKSPACE_H
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+template<typename T>
+struct BasicWorkspace {
+    BasicWorkspace() : batchSize(0) {}
+
+    /**
+    * Number of samples the buffers have room for
+    */
+    size_t batchSize;
+
+    /**
+    * The activations of each layer (batchSize x numNeurons)
+    */
+    vector<vector<T>> activations;
+
+    /**
+    * The error values of each layer (batchSize x numNeurons)
+    */
+    vector<vector<T>> deltas;
+
+    /**
+    * The weight gradients of each layer (numNeurons x numInputs, same layout as the weights)
+    */
+    vector<vector<T>> gradients;
+
+    /**
+    * A copy of the weights of each layer read with relaxed atomic loads, used by
+    * computeGradientsRelaxed while other threads update the weights (empty otherwise)
+    */
+    vector<vector<T>> weights;
+};
+
+typedef BasicWorkspace<double> Workspace;
+
+#endif
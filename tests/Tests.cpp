@@ -0,0 +1,731 @@
+/**
+* Tests
+*
+* The tests of the nn library. Every test prints its result, the process exits with 1 if one of
+* them failed. ctest runs this executable once for every value of NN_SIMD, so the kernels of each
+* instruction set are compared against the naive loops (see CMakeLists.txt).
+*
+* @author Shivan Taher
+* @date 17.10.2026
+*/
+
+#include <nn/BinaryModel.h>
+#include <nn/Checkpointer.h>
+#include <nn/InferenceNet.h>
+#include <nn/InferenceServer.h>
+#include <nn/Kernels.h>
+#include <nn/NeuralNet.h>
+#include <nn/QuantizedNet.h>
+#include <nn/Simd.h>
+
+#include <atomic>
+#include <fcntl.h>
+#include <fstream>
+#include <math.h>
+#include <new>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace std;
+
+//
+// Allocation counting
+//
+
+static atomic<size_t> numAllocations(0);
+
+void* operator new(size_t size) {
+    numAllocations++;
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == 0)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    numAllocations++;
+    return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return operator new(size, nothrow);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+//
+// Tests
+//
+
+/**
+* Runs the forward pass taking a pointer and a length repeatedly after one warm-up call and
+* returns false if one of the calls allocated memory
+*/
+template<typename T>
+static bool testForwardAllocations(NeuralNetBase::SigmoidMode mode) {
+    BasicNeuralNet<T> net("allocations");
+    net.add(Layer::INPUT, 37);
+    net.add(Layer::HIDDEN, 64);
+    net.add(Layer::HIDDEN, 19);
+    net.add(Layer::OUTPUT, 5);
+    net.setSigmoidMode(mode);
+
+    vector<T> inputs(37);
+    for (size_t i = 0; i < inputs.size(); i++)
+        inputs[i] = T(i % 7) / 7 - T(0.5);
+
+    // The first call may set up lazily built state like the sigmoid table
+    if (net.calculateOutputs(&inputs[0], inputs.size()) == 0)
+        return false;
+
+    size_t before = numAllocations;
+    for (int i = 0; i < 100; i++) {
+        inputs[i % inputs.size()] += T(0.01);
+        if (net.calculateOutputs(&inputs[0], inputs.size()) == 0)
+            return false;
+    }
+
+    return numAllocations == before;
+}
+
+/**
+* Returns a deterministic pseudo random value in [-1, 1]
+*/
+static double nextValue() {
+    static unsigned int state = 12345;
+    state = state * 1103515245 + 12345;
+    return (double) ((state >> 8) & 0xffff) / 0x8000 - 1;
+}
+
+template<typename T>
+static vector<T> randomMatrix(size_t rows, size_t cols, size_t ld) {
+    vector<T> matrix(rows * ld);
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < ld; j++)
+            // The padding behind each row must not be read, a NaN would show up in the results
+            matrix[i * ld + j] = j < cols ? (T) nextValue() : (T) NAN;
+    return matrix;
+}
+
+/**
+* Returns true if the values are equal up to the rounding error of sums of n products
+*/
+template<typename T>
+static bool closeEnough(const vector<T>& values, const vector<T>& expected, size_t n) {
+    double epsilon = (sizeof(T) == sizeof(float) ? 1e-6 : 1e-14) * (n + 1) * 4;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (!(fabs(values[i] - expected[i]) <= epsilon * (1 + fabs(expected[i]))))
+            return false;
+    }
+    return true;
+}
+
+/**
+* Compares gemm with a naive triple loop for all combinations of the transpose flags. The
+* leading dimensions are larger than the number of columns.
+*/
+template<typename T>
+static bool testGemm(size_t M, size_t N, size_t K) {
+    for (int trans = 0; trans < 4; trans++) {
+        bool transA = (trans & 1) != 0;
+        bool transB = (trans & 2) != 0;
+
+        // op(A) is M x K and op(B) K x N, so A is stored as K x M if transposed
+        size_t rowsA = transA ? K : M, colsA = transA ? M : K;
+        size_t rowsB = transB ? N : K, colsB = transB ? K : N;
+        size_t lda = colsA + 3, ldb = colsB + 5, ldc = N + 2;
+
+        vector<T> A = randomMatrix<T>(rowsA, colsA, lda);
+        vector<T> B = randomMatrix<T>(rowsB, colsB, ldb);
+        vector<T> C = randomMatrix<T>(M, N, ldc);
+        vector<T> expected = C;
+
+        T alpha = (T) 0.75, beta = (T) -0.5;
+        for (size_t i = 0; i < M; i++) {
+            for (size_t j = 0; j < N; j++) {
+                double sum = 0;
+                for (size_t p = 0; p < K; p++) {
+                    double a = transA ? A[p * lda + i] : A[i * lda + p];
+                    double b = transB ? B[j * ldb + p] : B[p * ldb + j];
+                    sum += a * b;
+                }
+                expected[i * ldc + j] = (T) (alpha * sum + beta * (double) C[i * ldc + j]);
+            }
+        }
+
+        gemm(transA, transB, M, N, K, alpha, A.data(), lda, B.data(), ldb, beta, C.data(), ldc);
+
+        // The padding of C is NaN on both sides and compared as well
+        for (size_t i = 0; i < C.size(); i++) {
+            if (isnan(C[i]) != isnan(expected[i]))
+                return false;
+            if (isnan(C[i]))
+                C[i] = expected[i] = 0;
+        }
+
+        if (!closeEnough(C, expected, K))
+            return false;
+    }
+    return true;
+}
+
+/**
+* Compares gemv and gemvTransposed with naive loops
+*/
+template<typename T>
+static bool testGemv(size_t rows, size_t cols) {
+    size_t lda = cols + 3;
+    vector<T> A = randomMatrix<T>(rows, cols, lda);
+    vector<T> x = randomMatrix<T>(1, max(rows, cols), max(rows, cols));
+    vector<T> y = randomMatrix<T>(1, rows, rows);
+    vector<T> yTransposed = randomMatrix<T>(1, cols, cols);
+
+    T alpha = (T) 1.25, beta = (T) 0.5;
+    vector<T> expected(rows);
+    for (size_t i = 0; i < rows; i++) {
+        double sum = 0;
+        for (size_t j = 0; j < cols; j++)
+            sum += (double) A[i * lda + j] * x[j];
+        expected[i] = (T) (alpha * sum + beta * (double) y[i]);
+    }
+
+    vector<T> expectedTransposed(cols);
+    for (size_t j = 0; j < cols; j++) {
+        double sum = 0;
+        for (size_t i = 0; i < rows; i++)
+            sum += (double) A[i * lda + j] * x[i];
+        expectedTransposed[j] = (T) (alpha * sum + beta * (double) yTransposed[j]);
+    }
+
+    gemv(rows, cols, alpha, A.data(), lda, x.data(), beta, y.data());
+    gemvTransposed(rows, cols, alpha, A.data(), lda, x.data(), beta, yTransposed.data());
+
+    return closeEnough(y, expected, cols) && closeEnough(yTransposed, expectedTransposed, rows);
+}
+
+/**
+* Compares the rank-1 update ger with a naive loop, the padding of A must stay untouched
+*/
+template<typename T>
+static bool testGer(size_t rows, size_t cols) {
+    size_t lda = cols + 3;
+    vector<T> A = randomMatrix<T>(rows, cols, lda);
+    vector<T> x = randomMatrix<T>(1, rows, rows);
+    vector<T> y = randomMatrix<T>(1, cols, cols);
+
+    T alpha = (T) -0.75;
+    vector<T> expected = A;
+    for (size_t i = 0; i < rows; i++)
+        for (size_t j = 0; j < cols; j++)
+            expected[i * lda + j] = (T) (alpha * (double) x[i] * y[j] + A[i * lda + j]);
+
+    ger(rows, cols, alpha, x.data(), y.data(), A.data(), lda);
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = cols; j < lda; j++) {
+            if (!isnan(A[i * lda + j]))
+                return false;
+            A[i * lda + j] = expected[i * lda + j] = 0;
+        }
+    }
+
+    return closeEnough(A, expected, 1);
+}
+
+/**
+* Compares the fused rank-1 update of the delta weights and the weights with a naive loop:
+* D = alpha * x * y^T + beta * D, W += D. The padding of D and W must stay untouched.
+*/
+template<typename T>
+static bool testGerMomentumUpdate(size_t rows, size_t cols) {
+    size_t ld = cols + 3;
+    vector<T> D = randomMatrix<T>(rows, cols, ld);
+    vector<T> W = randomMatrix<T>(rows, cols, ld);
+    vector<T> x = randomMatrix<T>(1, rows, rows);
+    vector<T> y = randomMatrix<T>(1, cols, cols);
+
+    T alpha = (T) 0.375, beta = (T) 0.9;
+    vector<T> expectedD = D, expectedW = W;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            double d = alpha * (double) x[i] * y[j] + beta * (double) D[i * ld + j];
+            expectedD[i * ld + j] = (T) d;
+            expectedW[i * ld + j] = (T) (W[i * ld + j] + d);
+        }
+    }
+
+    gerMomentumUpdate(rows, cols, alpha, x.data(), y.data(), beta, D.data(), W.data(), ld);
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = cols; j < ld; j++) {
+            if (!isnan(D[i * ld + j]) || !isnan(W[i * ld + j]))
+                return false;
+            D[i * ld + j] = W[i * ld + j] = expectedD[i * ld + j] = expectedW[i * ld + j] = 0;
+        }
+    }
+
+    return closeEnough(D, expectedD, 2) && closeEnough(W, expectedW, 2);
+}
+
+/**
+* Compares momentumUpdate (the SIMD update kernel) with a naive loop: d = alpha * x + beta * d,
+* w += d. The values behind the first n must stay untouched.
+*/
+template<typename T>
+static bool testMomentumUpdate(size_t n) {
+    vector<T> x = randomMatrix<T>(1, n, n + 5);
+    vector<T> d = randomMatrix<T>(1, n, n + 5);
+    vector<T> w = randomMatrix<T>(1, n, n + 5);
+
+    T alpha = (T) -1.5, beta = (T) 0.5;
+    vector<T> expectedD = d, expectedW = w;
+    for (size_t i = 0; i < n; i++) {
+        double delta = alpha * (double) x[i] + beta * (double) d[i];
+        expectedD[i] = (T) delta;
+        expectedW[i] = (T) (w[i] + delta);
+    }
+
+    momentumUpdate(n, alpha, x.data(), beta, d.data(), w.data());
+
+    for (size_t i = n; i < d.size(); i++) {
+        if (!isnan(d[i]) || !isnan(w[i]))
+            return false;
+        d[i] = w[i] = expectedD[i] = expectedW[i] = 0;
+    }
+
+    return closeEnough(d, expectedD, 2) && closeEnough(w, expectedW, 2);
+}
+
+/**
+* Compares gemvInt8 and gemmInt8 with naive loops, the integer results have to be exact
+*/
+static bool testInt8(size_t M, size_t N, size_t K) {
+    size_t lda = K + 3, ldb = K + 7, ldc = M + 1;
+    vector<int8_t> A(M * lda);
+    vector<uint8_t> B(N * ldb);
+    for (size_t i = 0; i < A.size(); i++)
+        A[i] = (int8_t) (nextValue() * 127);
+    for (size_t i = 0; i < B.size(); i++)
+        B[i] = (uint8_t) ((nextValue() + 1) * 127.5);
+
+    vector<int32_t> expected(N * ldc, -1);
+    for (size_t n = 0; n < N; n++) {
+        for (size_t m = 0; m < M; m++) {
+            int32_t sum = 0;
+            for (size_t k = 0; k < K; k++)
+                sum += (int32_t) A[m * lda + k] * B[n * ldb + k];
+            expected[n * ldc + m] = sum;
+        }
+    }
+
+    vector<int32_t> C(N * ldc, -1);
+    gemmInt8(M, N, K, A.data(), lda, B.data(), ldb, C.data(), ldc);
+    if (C != expected)
+        return false;
+
+    vector<int32_t> y(M);
+    gemvInt8(M, K, A.data(), lda, B.data(), y.data());
+    for (size_t m = 0; m < M; m++) {
+        if (y[m] != expected[m])
+            return false;
+    }
+    return true;
+}
+
+/**
+* Compares sigmoidFast and sigmoidTable with 1 / (1 + exp(-x)) over [-40, 40] and checks the
+* maximum absolute errors documented in Kernels.h (and in NeuralNet.h)
+*/
+template<typename T>
+static bool testSigmoidAccuracy(double fastBound, double tableBound) {
+    // An odd number of values, so the scalar tail of the SIMD variants is included
+    const size_t n = 80001;
+    vector<T> x(n), fast(n), table(n);
+
+    for (size_t i = 0; i < n; i++)
+        x[i] = (T) (-40 + 80.0 * i / (n - 1));
+
+    sigmoidFast(n, x.data(), fast.data());
+    sigmoidTable(n, x.data(), table.data());
+
+    double fastError = 0, tableError = 0;
+    for (size_t i = 0; i < n; i++) {
+        double expected = 1 / (1 + exp(-(double) x[i]));
+        fastError = max(fastError, fabs(fast[i] - expected));
+        tableError = max(tableError, fabs(table[i] - expected));
+    }
+
+    return fastError <= fastBound && tableError <= tableBound;
+}
+
+/**
+* Runs NaN and infinite values through sigmoidTable at every position of a vector, so they pass
+* both the SIMD loop and the scalar tail. NaN and -inf must give the value of -16, +inf the value
+* of 16.
+*/
+template<typename T>
+static bool testSigmoidTableNonFinite() {
+    const T specials[] = { (T) NAN, (T) INFINITY, (T) -INFINITY };
+    const size_t n = 37;
+
+    T lower, upper, bounds[2] = { -16, 16 };
+    sigmoidTable(1, &bounds[0], &lower);
+    sigmoidTable(1, &bounds[1], &upper);
+
+    for (size_t k = 0; k < 3; k++) {
+        for (size_t position = 0; position < n; position++) {
+            vector<T> x(n, (T) 0.25), y(n);
+            x[position] = specials[k];
+
+            sigmoidTable(n, x.data(), y.data());
+
+            if (y[position] != (k == 1 ? upper : lower))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+* Returns the name of a temporary file in the working directory, unique for this process so the
+* ctest runs of the SIMD levels can run at the same time
+*/
+static string temporaryFile(const char* name) {
+    char filename[64];
+    snprintf(filename, sizeof(filename), "nn_tests_%d_%s", (int) getpid(), name);
+    return filename;
+}
+
+/**
+* Trains a network with backpropagation() and checks that the checkpointer wrote a snapshot
+* which can be loaded again
+*/
+static bool testBackpropagationCheckpoints() {
+    NeuralNet net("checkpoints");
+    net.add(Layer::INPUT, 3);
+    net.add(Layer::HIDDEN, 4);
+    net.add(Layer::OUTPUT, 2);
+
+    string filename = temporaryFile("checkpoint.bin");
+    size_t numWritten;
+
+    {
+        Checkpointer checkpointer(net, filename);
+        net.setCheckpointer(&checkpointer, 5);
+
+        for (int i = 0; i < 20; i++)
+            net.backpropagation({ 0.1, 0.5, 0.9 }, { 1, 0 });
+
+        checkpointer.wait();
+        numWritten = checkpointer.getNumWritten();
+        net.setCheckpointer(0, 0);
+    }
+
+    NeuralNet loaded("loaded");
+    bool valid = numWritten > 0 && loaded.load(filename) && loaded.getNumLayers() == 3;
+
+    remove(filename.c_str());
+    return valid;
+}
+
+/**
+* Overwrites a 64 bit value of a file, e.g. to corrupt a header
+*/
+static bool patchFile(const string& filename, long offset, uint64_t value) {
+    FILE* file = fopen(filename.c_str(), "r+b");
+    if (file == 0)
+        return false;
+
+    bool written = fseek(file, offset, SEEK_SET) == 0 && fwrite(&value, sizeof(value), 1, file) == 1;
+    return fclose(file) == 0 && written;
+}
+
+/**
+* Saves a quantized model and loads it again with corrupt sizes in the headers, which must be
+* rejected before anything is allocated
+*/
+static bool testQuantizedModelValidation() {
+    NeuralNet net("quantized");
+    net.add(Layer::INPUT, 3);
+    net.add(Layer::OUTPUT, 2);
+
+    vector<double> inputs = { 0.1, 0.5, 0.9 };
+    BasicQuantizedNet<double> quantized, loaded;
+    string filename = temporaryFile("quantized.bin");
+
+    bool valid = quantized.quantize(net, inputs.data(), 1) && quantized.save(filename) && loaded.load(filename);
+
+    // The number of layers behind the magic, the version and the byte order mark
+    valid = valid && patchFile(filename, 16, uint64_t(1) << 60) && !loaded.load(filename);
+
+    // The number of inputs of the first layer, 2 * sizeof(double) + numInputs wraps to 1
+    valid = valid && patchFile(filename, 16, 2) && loaded.load(filename) &&
+            patchFile(filename, 32, ~uint64_t(0) - 14) && !loaded.load(filename);
+
+    remove(filename.c_str());
+    return valid;
+}
+
+/**
+* Saves a network as JSON and in the binary format and checks that the loaded networks calculate
+* the same outputs
+*/
+template<typename T>
+static bool testSaveLoad() {
+    BasicNeuralNet<T> net("saved");
+    net.add(Layer::INPUT, 3);
+    net.add(Layer::HIDDEN, 5);
+    net.add(Layer::OUTPUT, 2);
+
+    vector<T> inputs = { (T) 0.1, (T) -0.7, (T) 0.9 };
+    vector<T> expected = net.calculateOutputs(inputs);
+    string jsonFile = temporaryFile("model.json"), binaryFile = temporaryFile("model.bin");
+
+    BasicNeuralNet<T> fromJson("json"), fromBinary("binary");
+    BasicInferenceNet<T> inference;
+
+    bool valid = net.save(jsonFile) && net.saveBinary(binaryFile, true) && fromJson.load(jsonFile) &&
+                 fromBinary.load(binaryFile) && inference.load(jsonFile);
+
+    valid = valid && fromJson.calculateOutputs(inputs) == expected && fromBinary.calculateOutputs(inputs) == expected &&
+            inference.calculateOutputs(inputs) == expected;
+
+    remove(jsonFile.c_str());
+    remove(binaryFile.c_str());
+    return valid;
+}
+
+/**
+* Saves a network with NaN and infinite weights as JSON (written as null and 1e+9999) and checks
+* that NeuralNet and InferenceNet read them back
+*/
+template<typename T>
+static bool testNonFiniteWeights() {
+    BasicNeuralNet<T> net("nonfinite");
+    net.add(Layer::INPUT, 2);
+    net.add(Layer::OUTPUT, 2);
+
+    // The network has no setter for single weights
+    T* weights = const_cast<T*>(net.getLayer(1).weights);
+    weights[0] = (T) NAN;
+    weights[1] = (T) INFINITY;
+    weights[2] = (T) -INFINITY;
+
+    string filename = temporaryFile("nonfinite.json");
+    BasicNeuralNet<T> loaded("loaded");
+    BasicInferenceNet<T> inference;
+
+    bool valid = net.save(filename) && loaded.load(filename) && inference.load(filename);
+
+    for (int i = 0; valid && i < 2; i++) {
+        const T* values = i == 0 ? loaded.getLayer(1).weights : inference.getLayer(1).weights;
+        valid = isnan(values[0]) && values[1] == (T) INFINITY && values[2] == (T) -INFINITY && values[3] == weights[3];
+    }
+
+    remove(filename.c_str());
+    return valid;
+}
+
+/**
+* Loads a JSON file whose numbers pass the first pass of the reader (which only counts them) but
+* not the conversion of the second pass. The load must fail and leave the networks unchanged.
+*/
+static bool testLoadMalformed() {
+    NeuralNet net("saved");
+    net.add(Layer::INPUT, 3);
+    net.add(Layer::HIDDEN, 5);
+    net.add(Layer::OUTPUT, 2);
+
+    string filename = temporaryFile("malformed.json");
+    if (!net.save(filename))
+        return false;
+
+    string text;
+    {
+        ifstream in(filename.c_str());
+        text.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    // "--" consists of number characters, but strtod can not convert it. The weights of the input
+    // layer are empty, the first weight of the hidden layer is changed.
+    size_t position = text.find("\"weights\":[");
+    while (position != string::npos && text[position + 11] == ']')
+        position = text.find("\"weights\":[", position + 11);
+
+    if (position == string::npos)
+        return false;
+
+    text.insert(position + 11, "--");
+    {
+        ofstream out(filename.c_str());
+        out << text;
+    }
+
+    NeuralNet target("target");
+    target.add(Layer::INPUT, 2);
+    target.add(Layer::OUTPUT, 1);
+
+    InferenceNet inference(target);
+    vector<double> inputs = { 0.25, 0.75 };
+    vector<double> expected = target.calculateOutputs(inputs);
+
+    bool valid = !target.load(filename) && target.getNumLayers() == 2 && target.calculateOutputs(inputs) == expected &&
+                 !inference.load(filename) && inference.getNumLayers() == 2 && inference.calculateOutputs(inputs) == expected;
+
+    remove(filename.c_str());
+    return valid;
+}
+
+/**
+* Saves a binary model and changes its layer table to two layers of 2^32 neurons without bias.
+* Their 2^64 weights wrap to a section of 0 bytes, the header must be rejected anyway.
+*/
+static bool testBinaryModelValidation() {
+    NeuralNet net("binary");
+    net.setBiasStatus(false);
+    net.add(Layer::INPUT, 2);
+    net.add(Layer::OUTPUT, 1);
+
+    string filename = temporaryFile("overflow.bin");
+    NeuralNet loaded("loaded");
+
+    bool valid = net.saveBinary(filename) && loaded.load(filename);
+
+    // The layer table (numNeurons and hasBias of every layer) follows the header
+    long table = sizeof(BinaryModelHeader);
+    valid = valid && patchFile(filename, table, uint64_t(1) << 32) && patchFile(filename, table + 16, uint64_t(1) << 32) &&
+            patchFile(filename, offsetof(BinaryModelHeader, sectionSize), 0) && !loaded.load(filename) &&
+            loaded.getNumInputs() == 2;
+
+    remove(filename.c_str());
+    return valid;
+}
+
+/**
+* Serves a file with a valid request, a request line of 10000 bytes and another valid request.
+* The server must answer the first request and close the connection at the long line.
+*/
+static bool testServerLineLimit() {
+    NeuralNet net("server");
+    net.add(Layer::INPUT, 2);
+    net.add(Layer::OUTPUT, 1);
+
+    string requests = temporaryFile("requests.txt");
+    string responses = temporaryFile("responses.txt");
+    {
+        ofstream out(requests.c_str());
+        out << "0.25 0.75\n" << string(10000, '1') << "\n0.25 0.75\n";
+    }
+
+    InferenceNet inference(net);
+    int inFd = open(requests.c_str(), O_RDONLY);
+    int outFd = open(responses.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    bool valid = inFd >= 0 && outFd >= 0;
+
+    if (valid) {
+        InferenceServer server(inference, 4, 100);
+        server.serve(inFd, outFd);
+    }
+
+    if (inFd >= 0)
+        close(inFd);
+    if (outFd >= 0)
+        close(outFd);
+
+    string line;
+    size_t numLines = 0;
+    ifstream in(responses.c_str());
+    while (getline(in, line))
+        numLines++;
+
+    remove(requests.c_str());
+    remove(responses.c_str());
+    return valid && numLines == 1;
+}
+
+static int numFailed = 0;
+
+static void report(const char* name, bool passed) {
+    printf("%-50s %s\n", name, passed ? "passed" : "FAILED");
+    if (!passed)
+        numFailed++;
+}
+
+/**
+* Runs the kernel tests for one scalar type with sizes which are not multiples of the register
+* tiles and, for the larger ones, span several cache blocks of gemm (see Kernels.cpp)
+*/
+template<typename T>
+static void testKernels(const char* type) {
+    static const size_t sizes[][3] = {
+        { 1, 1, 1 }, { 3, 5, 7 }, { 4, 4, 4 }, { 13, 17, 19 }, { 1, 33, 2 }, { 67, 9, 259 }, { 5, 1031, 3 }
+    };
+
+    char name[64];
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t M = sizes[i][0], N = sizes[i][1], K = sizes[i][2];
+
+        snprintf(name, sizeof(name), "gemm %zux%zux%zu (%s)", M, N, K, type);
+        report(name, testGemm<T>(M, N, K));
+
+        snprintf(name, sizeof(name), "gemv %zux%zu (%s)", M, K, type);
+        report(name, testGemv<T>(M, K));
+
+        snprintf(name, sizeof(name), "ger %zux%zu (%s)", M, N, type);
+        report(name, testGer<T>(M, N));
+
+        snprintf(name, sizeof(name), "gerMomentumUpdate %zux%zu (%s)", M, N, type);
+        report(name, testGerMomentumUpdate<T>(M, N));
+
+        snprintf(name, sizeof(name), "momentumUpdate %zu (%s)", N, type);
+        report(name, testMomentumUpdate<T>(N));
+    }
+}
+
+int main() {
+    printf("SIMD kernels: %s, 8 bit kernels: %s\n\n", simdKernels<double>().name, simdInt8Kernels().name);
+
+    testKernels<double>("double");
+    testKernels<float>("float");
+
+    report("gemvInt8/gemmInt8 1x1x1", testInt8(1, 1, 1));
+    report("gemvInt8/gemmInt8 7x3x13", testInt8(7, 3, 13));
+    report("gemvInt8/gemmInt8 33x17x131", testInt8(33, 17, 131));
+    report("gemvInt8/gemmInt8 9x5x1027", testInt8(9, 5, 1027));
+
+    report("forward pass allocations (double, exact)", testForwardAllocations<double>(NeuralNetBase::EXACT));
+    report("forward pass allocations (double, fast)", testForwardAllocations<double>(NeuralNetBase::FAST));
+    report("forward pass allocations (double, table)", testForwardAllocations<double>(NeuralNetBase::TABLE));
+    report("forward pass allocations (float, exact)", testForwardAllocations<float>(NeuralNetBase::EXACT));
+    report("forward pass allocations (float, fast)", testForwardAllocations<float>(NeuralNetBase::FAST));
+    report("forward pass allocations (float, table)", testForwardAllocations<float>(NeuralNetBase::TABLE));
+
+    report("sigmoid accuracy (double)", testSigmoidAccuracy<double>(2e-9, 8e-7));
+    report("sigmoid accuracy (float)", testSigmoidAccuracy<float>(2e-7, 1e-6));
+    report("sigmoidTable of NaN and infinity (double)", testSigmoidTableNonFinite<double>());
+    report("sigmoidTable of NaN and infinity (float)", testSigmoidTableNonFinite<float>());
+
+    report("save and load (double)", testSaveLoad<double>());
+    report("save and load (float)", testSaveLoad<float>());
+    report("load of a malformed model", testLoadMalformed());
+    report("NaN and infinite weights (double)", testNonFiniteWeights<double>());
+    report("NaN and infinite weights (float)", testNonFiniteWeights<float>());
+    report("checkpoints of backpropagation", testBackpropagationCheckpoints());
+    report("binary model header validation", testBinaryModelValidation());
+    report("server request line limit", testServerLineLimit());
+    report("quantized model header validation", testQuantizedModelValidation());
+
+    return numFailed == 0 ? 0 : 1;
+}